@@ -0,0 +1,335 @@
+// Copyright Donatien Rabiller. All rights reserved.
+
+// ImGui.Benchmark outside of the engine, writes the same JSON as the console command
+// Arguments: --filter <scene name part> --frames <count, default 100> --output <file, default stdout>
+// --baseline <file, default Resources/ImGuiBenchmarkBaseline.json> --max-ratio <frame time ratio, default 1.5>
+// Returns 2 when a scene is slower than the baseline by more than the max ratio
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ImGuiBenchmarkScenes.h"
+
+using namespace ImGuiBenchmarkScenes;
+
+// @NOTE: sizeof(FSlateVertex) and sizeof(SlateIndex) in UE 5.3, SlateBytes matches the in-engine results with them
+static constexpr size_t SlateVertexSize = 44;
+static constexpr size_t SlateIndexSize = 4;
+
+// Scene of a baseline, only what results are compared with
+struct FBaselineScene
+{
+	std::string Scene;
+	double MeanFrameTimeMs = 0.0;
+	double AllocationsPerFrame = 0.0;
+	double Vertices = 0.0;
+};
+
+struct FResult
+{
+	const char* Scene = nullptr;
+	int Frames = 0;
+	double MeanFrameTime = 0.0;
+	double MinFrameTime = 0.0;
+	double MaxFrameTime = 0.0;
+	double AllocationsPerFrame = 0.0;
+	double AllocatedBytesPerFrame = 0.0;
+	int Vertices = 0;
+	int Indices = 0;
+	int DrawCmds = 0;
+	int64_t SlateBytes = 0;
+	int64_t SlateBytesWithoutRanges = 0;
+	const FBaselineScene* Baseline = nullptr;
+
+	double GetFrameTimeRatio() const
+	{
+		return Baseline && Baseline->MeanFrameTimeMs > 0.0 ? MeanFrameTime * 1000.0 / Baseline->MeanFrameTimeMs : 0.0;
+	}
+};
+
+static double Seconds()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool ContainsNoCase(const char* Text, const std::string& Part)
+{
+	std::string Lower = Text;
+	std::string LowerPart = Part;
+	std::transform(Lower.begin(), Lower.end(), Lower.begin(), [](unsigned char C) { return (char)tolower(C); });
+	std::transform(LowerPart.begin(), LowerPart.end(), LowerPart.begin(), [](unsigned char C) { return (char)tolower(C); });
+	return Lower.find(LowerPart) != std::string::npos;
+}
+
+static FResult RunScene(const FScene& Scene, int Frames)
+{
+	std::vector<float> Values(Scene.NumValues);
+	MakeSineWave(Values.data(), Scene.NumValues);
+
+	// Every scene starts from a fresh context so layouts and plot states don't carry over, like in the engine
+	ImFontAtlas* FontAtlas = IM_NEW(ImFontAtlas)();
+	unsigned char* Pixels;
+	int Width, Height;
+	FontAtlas->GetTexDataAsRGBA32(&Pixels, &Width, &Height);
+
+	ImGuiContext* Context = ImGui::CreateContext(FontAtlas);
+	ImGui::SetCurrentContext(Context);
+	ImPlotContext* PlotContext = ImPlot::CreateContext();
+	ImPlot::SetCurrentContext(PlotContext);
+
+	FResult Result;
+	Result.Scene = Scene.Name;
+	Result.Frames = std::max(1, Frames / Scene.FrameDivisor);
+	Result.MinFrameTime = 1e30;
+
+	ImGuiIO& IO = ImGui::GetIO();
+	IO.IniFilename = nullptr;
+	IO.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+	IO.DisplaySize = DisplaySize;
+	IO.DeltaTime = 1.0f / 60.0f;
+
+	GAllocationCounter.Context = Context;
+	GAllocationCounter.NumAllocations = 0;
+	GAllocationCounter.NumAllocatedBytes = 0;
+
+	int64_t TotalAllocations = 0;
+	int64_t TotalAllocatedBytes = 0;
+	double TotalFrameTime = 0.0;
+	for (int Frame = -WarmupFrames; Frame < Result.Frames; ++Frame)
+	{
+		const int64_t FrameAllocations = GAllocationCounter.NumAllocations;
+		const int64_t FrameAllocatedBytes = GAllocationCounter.NumAllocatedBytes;
+		const double FrameStartTime = Seconds();
+		ImGui::NewFrame();
+		Scene.Draw(Values.data(), (int)Values.size());
+		ImGui::Render();
+		const double FrameTime = Seconds() - FrameStartTime;
+
+		if (Frame >= 0)
+		{
+			TotalFrameTime += FrameTime;
+			Result.MinFrameTime = std::min(Result.MinFrameTime, FrameTime);
+			Result.MaxFrameTime = std::max(Result.MaxFrameTime, FrameTime);
+			TotalAllocations += GAllocationCounter.NumAllocations - FrameAllocations;
+			TotalAllocatedBytes += GAllocationCounter.NumAllocatedBytes - FrameAllocatedBytes;
+		}
+	}
+	GAllocationCounter.Context = nullptr;
+
+	const ImDrawData* DrawData = ImGui::GetDrawData();
+	Result.Vertices = DrawData->TotalVtxCount;
+	Result.Indices = DrawData->TotalIdxCount;
+	for (const ImDrawList* DrawList : DrawData->CmdLists)
+	{
+		Result.DrawCmds += DrawList->CmdBuffer.Size;
+	}
+	CountSlateBytes(*DrawData, SlateVertexSize, SlateIndexSize, Result.SlateBytes, Result.SlateBytesWithoutRanges);
+	Result.MeanFrameTime = TotalFrameTime / Result.Frames;
+	Result.AllocationsPerFrame = (double)TotalAllocations / Result.Frames;
+	Result.AllocatedBytesPerFrame = (double)TotalAllocatedBytes / Result.Frames;
+
+	ImPlot::DestroyContext(PlotContext);
+	ImGui::DestroyContext(Context);
+	IM_DELETE(FontAtlas);
+
+	return Result;
+}
+
+// Compiler the target is built with, the "Build" field of the results
+static std::string GetBuildName()
+{
+#if defined(_MSC_VER)
+	return "Standalone, MSVC " + std::to_string(_MSC_VER);
+#elif defined(__clang__)
+	return "Standalone, Clang " __clang_version__;
+#elif defined(__GNUC__)
+	return "Standalone, GCC " __VERSION__;
+#else
+	return "Standalone, Unknown";
+#endif
+}
+
+// Value of the first "Key": field at or after From in Json, an empty string when there is none. Only reads the flat
+// objects WriteJson writes
+static std::string FindField(const std::string& Json, const char* Key, size_t From, size_t To)
+{
+	const std::string Pattern = std::string("\"") + Key + "\":";
+	const size_t KeyStart = Json.find(Pattern, From);
+	if (KeyStart == std::string::npos || KeyStart >= To)
+	{
+		return std::string();
+	}
+
+	size_t ValueStart = Json.find_first_not_of(" \t", KeyStart + Pattern.size());
+	if (ValueStart == std::string::npos)
+	{
+		return std::string();
+	}
+	if (Json[ValueStart] == '"')
+	{
+		const size_t ValueEnd = Json.find('"', ValueStart + 1);
+		return ValueEnd == std::string::npos ? std::string() : Json.substr(ValueStart + 1, ValueEnd - ValueStart - 1);
+	}
+	const size_t ValueEnd = Json.find_first_of(",}\n", ValueStart);
+	return Json.substr(ValueStart, ValueEnd == std::string::npos ? std::string::npos : ValueEnd - ValueStart);
+}
+
+// Reads the scenes of a baseline written by the same build, returns false when there is no such baseline
+static bool LoadBaseline(const char* Path, std::vector<FBaselineScene>& OutScenes)
+{
+	std::ifstream File(Path);
+	if (!File)
+	{
+		fprintf(stderr, "No ImGui benchmark baseline at %s\n", Path);
+		return false;
+	}
+	std::stringstream Stream;
+	Stream << File.rdbuf();
+	const std::string Json = Stream.str();
+
+	const std::string Build = FindField(Json, "Build", 0, Json.size());
+	if (Build != GetBuildName())
+	{
+		fprintf(stderr, "ImGui benchmark baseline at %s comes from \"%s\", not \"%s\", frame times aren't compared\n", Path, Build.c_str(), GetBuildName().c_str());
+		return false;
+	}
+
+	for (size_t SceneStart = Json.find("\"Scene\":"); SceneStart != std::string::npos;)
+	{
+		const size_t SceneEnd = Json.find('}', SceneStart);
+		FBaselineScene Scene;
+		Scene.Scene = FindField(Json, "Scene", SceneStart, SceneEnd);
+		Scene.MeanFrameTimeMs = atof(FindField(Json, "MeanFrameTimeMs", SceneStart, SceneEnd).c_str());
+		Scene.AllocationsPerFrame = atof(FindField(Json, "AllocationsPerFrame", SceneStart, SceneEnd).c_str());
+		Scene.Vertices = atof(FindField(Json, "Vertices", SceneStart, SceneEnd).c_str());
+		OutScenes.push_back(Scene);
+		SceneStart = SceneEnd == std::string::npos ? SceneEnd : Json.find("\"Scene\":", SceneEnd);
+	}
+	return true;
+}
+
+static void WriteJson(FILE* File, const std::vector<FResult>& Results)
+{
+	fprintf(File, "{\n");
+	fprintf(File, "\t\"ImGuiVersion\": \"%s\",\n", IMGUI_VERSION);
+	fprintf(File, "\t\"ImPlotVersion\": \"%s\",\n", IMPLOT_VERSION);
+	fprintf(File, "\t\"DrawIdxSize\": %d,\n", (int)sizeof(ImDrawIdx));
+	fprintf(File, "\t\"Build\": \"%s\",\n", GetBuildName().c_str());
+	fprintf(File, "\t\"Scenes\": [\n");
+	for (size_t Index = 0; Index < Results.size(); ++Index)
+	{
+		const FResult& Result = Results[Index];
+		fprintf(File, "\t\t{\n");
+		fprintf(File, "\t\t\t\"Scene\": \"%s\",\n", Result.Scene);
+		fprintf(File, "\t\t\t\"Frames\": %d,\n", Result.Frames);
+		fprintf(File, "\t\t\t\"MeanFrameTimeMs\": %.4f,\n", Result.MeanFrameTime * 1000.0);
+		fprintf(File, "\t\t\t\"MinFrameTimeMs\": %.4f,\n", Result.MinFrameTime * 1000.0);
+		fprintf(File, "\t\t\t\"MaxFrameTimeMs\": %.4f,\n", Result.MaxFrameTime * 1000.0);
+		fprintf(File, "\t\t\t\"AllocationsPerFrame\": %.2f,\n", Result.AllocationsPerFrame);
+		fprintf(File, "\t\t\t\"AllocatedBytesPerFrame\": %.2f,\n", Result.AllocatedBytesPerFrame);
+		fprintf(File, "\t\t\t\"Vertices\": %d,\n", Result.Vertices);
+		fprintf(File, "\t\t\t\"Indices\": %d,\n", Result.Indices);
+		fprintf(File, "\t\t\t\"DrawCmds\": %d,\n", Result.DrawCmds);
+		fprintf(File, "\t\t\t\"SlateBytes\": %lld,\n", (long long)Result.SlateBytes);
+		fprintf(File, "\t\t\t\"SlateBytesWithoutRanges\": %lld%s\n", (long long)Result.SlateBytesWithoutRanges, Result.Baseline ? "," : "");
+		if (Result.Baseline)
+		{
+			fprintf(File, "\t\t\t\"BaselineMeanFrameTimeMs\": %.4f,\n", Result.Baseline->MeanFrameTimeMs);
+			fprintf(File, "\t\t\t\"FrameTimeRatio\": %.4f,\n", Result.GetFrameTimeRatio());
+			fprintf(File, "\t\t\t\"BaselineAllocationsPerFrame\": %.2f,\n", Result.Baseline->AllocationsPerFrame);
+			fprintf(File, "\t\t\t\"BaselineVertices\": %.0f\n", Result.Baseline->Vertices);
+		}
+		fprintf(File, "\t\t}%s\n", Index + 1 < Results.size() ? "," : "");
+	}
+	fprintf(File, "\t]\n");
+	fprintf(File, "}\n");
+}
+
+int main(int Argc, char** Argv)
+{
+	std::string Filter;
+	int Frames = 100;
+	const char* OutputPath = nullptr;
+	const char* BaselinePath = IMGUI_BENCHMARK_BASELINE;
+	double MaxRatio = 1.5;
+	for (int Arg = 1; Arg < Argc; ++Arg)
+	{
+		if (!strcmp(Argv[Arg], "--filter") && Arg + 1 < Argc)
+		{
+			Filter = Argv[++Arg];
+		}
+		else if (!strcmp(Argv[Arg], "--frames") && Arg + 1 < Argc)
+		{
+			Frames = std::max(1, atoi(Argv[++Arg]));
+		}
+		else if (!strcmp(Argv[Arg], "--output") && Arg + 1 < Argc)
+		{
+			OutputPath = Argv[++Arg];
+		}
+		else if (!strcmp(Argv[Arg], "--baseline") && Arg + 1 < Argc)
+		{
+			BaselinePath = Argv[++Arg];
+		}
+		else if (!strcmp(Argv[Arg], "--max-ratio") && Arg + 1 < Argc)
+		{
+			MaxRatio = atof(Argv[++Arg]);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [--filter <scene name part>] [--frames <count>] [--output <file>] [--baseline <file>] [--max-ratio <ratio>]\n", Argv[0]);
+			return 1;
+		}
+	}
+
+	std::vector<FBaselineScene> BaselineScenes;
+	LoadBaseline(BaselinePath, BaselineScenes);
+
+	InstallAllocationCounter();
+
+	std::vector<FResult> Results;
+	bool bRegressed = false;
+	for (const FScene& Scene : Scenes)
+	{
+		if (Filter.empty() || ContainsNoCase(Scene.Name, Filter))
+		{
+			Results.push_back(RunScene(Scene, Frames));
+			FResult& Result = Results.back();
+			for (const FBaselineScene& BaselineScene : BaselineScenes)
+			{
+				if (BaselineScene.Scene == Scene.Name)
+				{
+					Result.Baseline = &BaselineScene;
+				}
+			}
+
+			const double Ratio = Result.GetFrameTimeRatio();
+			fprintf(stderr, "ImGui benchmark %s: %.3f ms, %.0f allocations, %d vertices", Result.Scene, Result.MeanFrameTime * 1000.0, Result.AllocationsPerFrame, Result.Vertices);
+			if (Ratio > 0.0)
+			{
+				fprintf(stderr, ", x%.2f baseline%s", Ratio, Ratio > MaxRatio ? " REGRESSED" : "");
+			}
+			fprintf(stderr, "\n");
+			bRegressed |= Ratio > MaxRatio;
+		}
+	}
+
+	FILE* File = OutputPath ? fopen(OutputPath, "w") : stdout;
+	if (!File)
+	{
+		fprintf(stderr, "Failed to write ImGui benchmark results to %s\n", OutputPath);
+		return 1;
+	}
+	WriteJson(File, Results);
+	if (OutputPath)
+	{
+		fclose(File);
+	}
+	return bRegressed ? 2 : 0;
+}
@@ -0,0 +1,481 @@
+﻿// Copyright Donatien Rabiller. All rights reserved.
+
+#include "ImGuiBenchmark.h"
+
+#include <implot.h>
+
+#include "imgui.h"
+#include "imgui_internal.h"
+#include "ImGuiBenchmarkScenes.h"
+#include "ImGuiSubsystem.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Rendering/RenderingCommon.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "UnrealImGuiDocker.h"
+
+#if WITH_IMGUI_BENCHMARK
+
+// Live measurement of the interop code, see ImGui.PerfReport
+struct FImGuiPerfReport
+{
+	int32 FramesToRecord = 0;
+	FString BaselinePath;
+	bool bQuitWhenDone = false;
+
+	double FrameTimers[(int32)EImGuiPerfTimer::Num] = {};
+	TArray<double> Samples[(int32)EImGuiPerfTimer::Num]; // Per frame totals, in seconds
+	FDelegateHandle EndFrameHandle;
+	bool bFinishing = false; // All frames are recorded, the report is written on the next core ticker tick
+};
+
+static TUniquePtr<FImGuiPerfReport> GImGuiPerfReport;
+static FString GImGuiLastPerfReportPath;
+
+FImGuiPerfScope::FImGuiPerfScope(EImGuiPerfTimer InTimer)
+	: Timer(InTimer)
+	, StartTime(GImGuiPerfReport ? FPlatformTime::Seconds() : 0.0)
+{
+}
+
+FImGuiPerfScope::~FImGuiPerfScope()
+{
+	if (GImGuiPerfReport && StartTime > 0.0)
+	{
+		check(IsInGameThread());
+		GImGuiPerfReport->FrameTimers[(int32)Timer] += FPlatformTime::Seconds() - StartTime;
+	}
+}
+
+namespace ImGuiBenchmark
+{
+
+using namespace ImGuiBenchmarkScenes;
+
+static TArray<float> MakeSineWave(int32 NumPoints)
+{
+	TArray<float> Values;
+	Values.SetNumUninitialized(NumPoints);
+	ImGuiBenchmarkScenes::MakeSineWave(Values.GetData(), NumPoints);
+	return Values;
+}
+
+static FImGuiBenchmarkResult RunScene(const FScene& Scene, int32 Frames)
+{
+	const TArray<float> Values = MakeSineWave(Scene.NumValues);
+
+	// Every scene starts from a fresh context so layouts and plot states don't carry over
+	ImFontAtlas* FontAtlas = IM_NEW(ImFontAtlas)();
+	unsigned char* Pixels;
+	int Width, Height;
+	FontAtlas->GetTexDataAsRGBA32(&Pixels, &Width, &Height);
+
+	FImGuiViewportContext BenchmarkContext;
+	BenchmarkContext.Context = ImGui::CreateContext(FontAtlas);
+	BenchmarkContext.PlotContext = ImPlot::CreateContext();
+
+	FImGuiBenchmarkResult Result;
+	Result.Scene = UTF8_TO_TCHAR(Scene.Name);
+	Result.Frames = FMath::Max(1, Frames / Scene.FrameDivisor);
+	Result.MinFrameTime = TNumericLimits<double>::Max();
+	{
+		FImGuiContextScope ContextScope(BenchmarkContext);
+		ImGuiIO& IO = ImGui::GetIO();
+		IO.IniFilename = nullptr;
+		IO.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+		IO.DisplaySize = DisplaySize;
+		IO.DeltaTime = 1.0f / 60.0f;
+
+		// Only allocations made while the benchmark context is current are counted, the subsystem contexts keep using
+		// the same allocator
+		GAllocationCounter.Context = BenchmarkContext.Context;
+		GAllocationCounter.NumAllocations = 0;
+		GAllocationCounter.NumAllocatedBytes = 0;
+
+		int64 TotalAllocations = 0;
+		int64 TotalAllocatedBytes = 0;
+		double TotalFrameTime = 0.0;
+		for (int32 Frame = -WarmupFrames; Frame < Result.Frames; ++Frame)
+		{
+			const int64 FrameAllocations = GAllocationCounter.NumAllocations;
+			const int64 FrameAllocatedBytes = GAllocationCounter.NumAllocatedBytes;
+			const double FrameStartTime = FPlatformTime::Seconds();
+			ImGui::NewFrame();
+			Scene.Draw(Values.GetData(), Values.Num());
+			ImGui::Render();
+			const double FrameTime = FPlatformTime::Seconds() - FrameStartTime;
+
+			if (Frame >= 0)
+			{
+				TotalFrameTime += FrameTime;
+				Result.MinFrameTime = FMath::Min(Result.MinFrameTime, FrameTime);
+				Result.MaxFrameTime = FMath::Max(Result.MaxFrameTime, FrameTime);
+				TotalAllocations += GAllocationCounter.NumAllocations - FrameAllocations;
+				TotalAllocatedBytes += GAllocationCounter.NumAllocatedBytes - FrameAllocatedBytes;
+			}
+		}
+		GAllocationCounter.Context = nullptr;
+
+		const ImDrawData* DrawData = ImGui::GetDrawData();
+		Result.Vertices = DrawData->TotalVtxCount;
+		Result.Indices = DrawData->TotalIdxCount;
+		for (const ImDrawList* DrawList : DrawData->CmdLists)
+		{
+			Result.DrawCmds += DrawList->CmdBuffer.Size;
+		}
+		CountSlateBytes(*DrawData, sizeof(FSlateVertex), sizeof(SlateIndex), Result.SlateBytes, Result.SlateBytesWithoutRanges);
+		Result.MeanFrameTime = TotalFrameTime / Result.Frames;
+		Result.AllocationsPerFrame = (double)TotalAllocations / Result.Frames;
+		Result.AllocatedBytesPerFrame = (double)TotalAllocatedBytes / Result.Frames;
+	}
+
+	ImPlot::DestroyContext(BenchmarkContext.PlotContext);
+	ImGui::DestroyContext(BenchmarkContext.Context);
+	IM_DELETE(FontAtlas);
+
+	return Result;
+}
+
+TArray<FImGuiBenchmarkResult> Run(const FString& Filter, int32 Frames)
+{
+	TArray<FImGuiBenchmarkResult> Results;
+	for (const FScene& Scene : Scenes)
+	{
+		if (Filter.IsEmpty() || FCString::Stristr(UTF8_TO_TCHAR(Scene.Name), *Filter))
+		{
+			Results.Add(RunScene(Scene, Frames));
+		}
+	}
+	return Results;
+}
+
+TSharedRef<FJsonObject> ToJson(TConstArrayView<FImGuiBenchmarkResult> Results, const TSharedPtr<FJsonObject>& Baseline)
+{
+	TMap<FString, TSharedPtr<FJsonObject>> BaselineScenes;
+	const TArray<TSharedPtr<FJsonValue>>* BaselineValues;
+	if (IsComparable(Baseline) && Baseline->TryGetArrayField(TEXT("Scenes"), BaselineValues))
+	{
+		for (const TSharedPtr<FJsonValue>& Value : *BaselineValues)
+		{
+			const TSharedPtr<FJsonObject> Scene = Value->AsObject();
+			BaselineScenes.Add(Scene->GetStringField(TEXT("Scene")), Scene);
+		}
+	}
+
+	TArray<TSharedPtr<FJsonValue>> SceneValues;
+	for (const FImGuiBenchmarkResult& Result : Results)
+	{
+		TSharedRef<FJsonObject> Scene = MakeShared<FJsonObject>();
+		Scene->SetStringField(TEXT("Scene"), Result.Scene);
+		Scene->SetNumberField(TEXT("Frames"), Result.Frames);
+		Scene->SetNumberField(TEXT("MeanFrameTimeMs"), Result.MeanFrameTime * 1000.0);
+		Scene->SetNumberField(TEXT("MinFrameTimeMs"), Result.MinFrameTime * 1000.0);
+		Scene->SetNumberField(TEXT("MaxFrameTimeMs"), Result.MaxFrameTime * 1000.0);
+		Scene->SetNumberField(TEXT("AllocationsPerFrame"), Result.AllocationsPerFrame);
+		Scene->SetNumberField(TEXT("AllocatedBytesPerFrame"), Result.AllocatedBytesPerFrame);
+		Scene->SetNumberField(TEXT("Vertices"), Result.Vertices);
+		Scene->SetNumberField(TEXT("Indices"), Result.Indices);
+		Scene->SetNumberField(TEXT("DrawCmds"), Result.DrawCmds);
+		Scene->SetNumberField(TEXT("SlateBytes"), Result.SlateBytes);
+		Scene->SetNumberField(TEXT("SlateBytesWithoutRanges"), Result.SlateBytesWithoutRanges);
+
+		if (const TSharedPtr<FJsonObject>* BaselineScene = BaselineScenes.Find(Result.Scene))
+		{
+			const double BaselineFrameTime = (*BaselineScene)->GetNumberField(TEXT("MeanFrameTimeMs"));
+			Scene->SetNumberField(TEXT("BaselineMeanFrameTimeMs"), BaselineFrameTime);
+			Scene->SetNumberField(TEXT("FrameTimeRatio"), BaselineFrameTime > 0.0 ? Result.MeanFrameTime * 1000.0 / BaselineFrameTime : 0.0);
+			Scene->SetNumberField(TEXT("BaselineAllocationsPerFrame"), (*BaselineScene)->GetNumberField(TEXT("AllocationsPerFrame")));
+			Scene->SetNumberField(TEXT("BaselineVertices"), (*BaselineScene)->GetNumberField(TEXT("Vertices")));
+		}
+		SceneValues.Add(MakeShared<FJsonValueObject>(Scene));
+	}
+
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetStringField(TEXT("ImGuiVersion"), UTF8_TO_TCHAR(IMGUI_VERSION));
+	Json->SetStringField(TEXT("ImPlotVersion"), UTF8_TO_TCHAR(IMPLOT_VERSION));
+	Json->SetNumberField(TEXT("DrawIdxSize"), sizeof(ImDrawIdx));
+	Json->SetStringField(TEXT("Build"), GetBuildName());
+	Json->SetArrayField(TEXT("Scenes"), SceneValues);
+	return Json;
+}
+
+FString GetBaselinePath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("ImGui") / TEXT("ImGuiBenchmarkBaseline.json");
+}
+
+FString GetBuildName()
+{
+	return FString::Printf(TEXT("Unreal %s %s"), *FEngineVersion::Current().ToString(EVersionComponent::Patch), LexToString(FApp::GetBuildConfiguration()));
+}
+
+bool IsComparable(const TSharedPtr<FJsonObject>& Baseline)
+{
+	FString Build;
+	return Baseline && Baseline->TryGetStringField(TEXT("Build"), Build) && Build == GetBuildName();
+}
+
+}
+
+static FAutoConsoleCommand CmdImGuiBenchmark(
+	TEXT("ImGui.Benchmark"),
+	TEXT("Builds scripted ImGui and ImPlot scenes in a headless context and writes frame times, allocations and vertex counts to Saved/Profiling/ImGui as JSON, compared with Saved/ImGui/ImGuiBenchmarkBaseline.json when it comes from the same engine version and build configuration. ")
+	TEXT("Arguments: Filter=<scene name part> Frames=<count, default 100> SaveBaseline (writes the results to Saved/ImGui/ImGuiBenchmarkBaseline.json)"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const FString Params = FString::Join(Args, TEXT(" "));
+		FString Filter;
+		FParse::Value(*Params, TEXT("Filter="), Filter);
+		int32 Frames = 100;
+		FParse::Value(*Params, TEXT("Frames="), Frames);
+
+		const TArray<FImGuiBenchmarkResult> Results = ImGuiBenchmark::Run(Filter, FMath::Max(Frames, 1));
+
+		const FString BaselinePath = ImGuiBenchmark::GetBaselinePath();
+		TSharedPtr<FJsonObject> Baseline;
+		FString BaselineText;
+		if (!FFileHelper::LoadFileToString(BaselineText, *BaselinePath))
+		{
+			UE_LOG(LogImGui, Warning, TEXT("No ImGui benchmark baseline at %s, run ImGui.Benchmark SaveBaseline to create it"), *BaselinePath);
+		}
+		else if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineText), Baseline) || !ImGuiBenchmark::IsComparable(Baseline))
+		{
+			UE_LOG(LogImGui, Warning, TEXT("ImGui benchmark baseline at %s doesn't come from %s, run ImGui.Benchmark SaveBaseline to replace it"), *BaselinePath, *ImGuiBenchmark::GetBuildName());
+		}
+
+		const TSharedRef<FJsonObject> Json = ImGuiBenchmark::ToJson(Results, Baseline);
+		for (const TSharedPtr<FJsonValue>& Value : Json->GetArrayField(TEXT("Scenes")))
+		{
+			const TSharedPtr<FJsonObject> Scene = Value->AsObject();
+			double Ratio = 0.0;
+			Scene->TryGetNumberField(TEXT("FrameTimeRatio"), Ratio);
+			UE_LOG(LogImGui, Display, TEXT("ImGui benchmark %s: %.3f ms, %.0f allocations, %d vertices, %.1f MB to Slate (%.1f MB without vertex ranges)%s"),
+			       *Scene->GetStringField(TEXT("Scene")),
+			       Scene->GetNumberField(TEXT("MeanFrameTimeMs")),
+			       Scene->GetNumberField(TEXT("AllocationsPerFrame")),
+			       (int32)Scene->GetNumberField(TEXT("Vertices")),
+			       Scene->GetNumberField(TEXT("SlateBytes")) / (1024.0 * 1024.0),
+			       Scene->GetNumberField(TEXT("SlateBytesWithoutRanges")) / (1024.0 * 1024.0),
+			       Ratio > 0.0 ? *FString::Printf(TEXT(", x%.2f baseline"), Ratio) : TEXT(""));
+		}
+
+		FString Output;
+		FJsonSerializer::Serialize(Json, TJsonWriterFactory<>::Create(&Output));
+		const FString FilePath = Args.Contains(TEXT("SaveBaseline"))
+			? BaselinePath
+			: FPaths::ProjectSavedDir() / TEXT("Profiling") / TEXT("ImGui") / FString::Printf(TEXT("ImGuiBenchmark-%s.json"), *FDateTime::Now().ToString());
+		if (FFileHelper::SaveStringToFile(Output, *FilePath))
+		{
+			UE_LOG(LogImGui, Display, TEXT("ImGui benchmark results written to %s"), *FilePath);
+		}
+		else
+		{
+			UE_LOG(LogImGui, Error, TEXT("Failed to write ImGui benchmark results to %s"), *FilePath);
+		}
+	})
+);
+
+static const TCHAR* PerfTimerNames[] = {TEXT("TickImGui"), TEXT("DrawDataSet"), TEXT("CanvasPaint")};
+static_assert(UE_ARRAY_COUNT(PerfTimerNames) == (int32)EImGuiPerfTimer::Num);
+
+static const FName PerfReportPanel = TEXT("ImGui.PerfReport");
+
+static void FinishPerfReport()
+{
+	const TUniquePtr<FImGuiPerfReport> Report = MoveTemp(GImGuiPerfReport);
+	FCoreDelegates::OnEndFrame.Remove(Report->EndFrameHandle);
+	if (UImGuiSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UImGuiSubsystem>() : nullptr)
+	{
+		Subsystem->UnregisterPanel(PerfReportPanel);
+	}
+
+	TSharedPtr<FJsonObject> Baseline;
+	FString BaselineText;
+	if (!Report->BaselinePath.IsEmpty() && FFileHelper::LoadFileToString(BaselineText, *Report->BaselinePath))
+	{
+		FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineText), Baseline);
+	}
+
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetNumberField(TEXT("Frames"), Report->FramesToRecord);
+	for (int32 Timer = 0; Timer < (int32)EImGuiPerfTimer::Num; ++Timer)
+	{
+		TArray<double>& Samples = Report->Samples[Timer];
+		Samples.Sort();
+		double Total = 0.0;
+		for (double Sample : Samples)
+		{
+			Total += Sample;
+		}
+
+		TSharedRef<FJsonObject> TimerJson = MakeShared<FJsonObject>();
+		const double MeanMs = Samples.Num() > 0 ? Total / Samples.Num() * 1000.0 : 0.0;
+		TimerJson->SetNumberField(TEXT("MeanMs"), MeanMs);
+		TimerJson->SetNumberField(TEXT("MedianMs"), Samples.Num() > 0 ? Samples[Samples.Num() / 2] * 1000.0 : 0.0);
+		TimerJson->SetNumberField(TEXT("MaxMs"), Samples.Num() > 0 ? Samples.Last() * 1000.0 : 0.0);
+
+		const TSharedPtr<FJsonObject>* BaselineTimer;
+		if (Baseline && Baseline->TryGetObjectField(PerfTimerNames[Timer], BaselineTimer))
+		{
+			const double BaselineMeanMs = (*BaselineTimer)->GetNumberField(TEXT("MeanMs"));
+			const double Ratio = BaselineMeanMs > 0.0 ? MeanMs / BaselineMeanMs : 0.0;
+			TimerJson->SetNumberField(TEXT("BaselineMeanMs"), BaselineMeanMs);
+			TimerJson->SetNumberField(TEXT("Ratio"), Ratio);
+			if (Ratio > 1.1)
+			{
+				UE_LOG(LogImGui, Warning, TEXT("ImGui perf report: %s regressed, %.3f ms against %.3f ms"), PerfTimerNames[Timer], MeanMs, BaselineMeanMs);
+			}
+		}
+		UE_LOG(LogImGui, Display, TEXT("ImGui perf report: %s %.3f ms"), PerfTimerNames[Timer], MeanMs);
+		Json->SetObjectField(PerfTimerNames[Timer], TimerJson);
+	}
+
+	FString Output;
+	FJsonSerializer::Serialize(Json, TJsonWriterFactory<>::Create(&Output));
+	const FString FilePath = FPaths::ProjectSavedDir() / TEXT("Profiling") / TEXT("ImGui") / FString::Printf(TEXT("ImGuiPerfReport-%s.json"), *FDateTime::Now().ToString());
+	if (FFileHelper::SaveStringToFile(Output, *FilePath))
+	{
+		UE_LOG(LogImGui, Display, TEXT("ImGui perf report written to %s"), *FilePath);
+		GImGuiLastPerfReportPath = FilePath;
+	}
+	else
+	{
+		UE_LOG(LogImGui, Error, TEXT("Failed to write ImGui perf report to %s"), *FilePath);
+	}
+
+	if (Report->bQuitWhenDone)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+static FAutoConsoleCommand CmdImGuiPerfReport(
+	TEXT("ImGui.PerfReport"),
+	TEXT("Draws synthetic ImGui windows and ImPlot plots through the subsystem and records the game thread cost of TickImGui, FImGuiDrawData::Set and SImGuiCanvas::OnPaint for a number of frames into Saved/Profiling/ImGui as JSON. ")
+	TEXT("Meant for -nullrhi runs, e.g. -ExecCmds=\"ImGui.PerfReport Quit\". ")
+	TEXT("Arguments: Frames=<count, default 300> Windows=<count, default 10> Rows=<text rows per window, default 100> PlotPoints=<points per window, default 10000> Baseline=<previous report to compare with> Quit"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		UImGuiSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UImGuiSubsystem>() : nullptr;
+		if (!Subsystem || GImGuiPerfReport)
+		{
+			return;
+		}
+
+		const FString Params = FString::Join(Args, TEXT(" "));
+		int32 Frames = 300;
+		int32 NumWindows = 10;
+		int32 NumRows = 100;
+		int32 NumPlotPoints = 10000;
+		FParse::Value(*Params, TEXT("Frames="), Frames);
+		FParse::Value(*Params, TEXT("Windows="), NumWindows);
+		FParse::Value(*Params, TEXT("Rows="), NumRows);
+		FParse::Value(*Params, TEXT("PlotPoints="), NumPlotPoints);
+
+		GImGuiPerfReport = MakeUnique<FImGuiPerfReport>();
+		GImGuiPerfReport->FramesToRecord = FMath::Max(Frames, 1);
+		GImGuiPerfReport->bQuitWhenDone = Args.Contains(TEXT("Quit"));
+		FParse::Value(*Params, TEXT("Baseline="), GImGuiPerfReport->BaselinePath);
+		GImGuiPerfReport->EndFrameHandle = FCoreDelegates::OnEndFrame.AddLambda([]()
+		{
+			if (GImGuiPerfReport->bFinishing)
+			{
+				return;
+			}
+			for (int32 Timer = 0; Timer < (int32)EImGuiPerfTimer::Num; ++Timer)
+			{
+				GImGuiPerfReport->Samples[Timer].Add(GImGuiPerfReport->FrameTimers[Timer]);
+				GImGuiPerfReport->FrameTimers[Timer] = 0.0;
+			}
+			if (GImGuiPerfReport->Samples[0].Num() >= GImGuiPerfReport->FramesToRecord)
+			{
+				// @NOTE: FinishPerfReport removes this delegate from OnEndFrame, which is broadcasting it
+				GImGuiPerfReport->bFinishing = true;
+				FTSTicker::GetCoreTicker().AddTicker(TEXT("ImGuiPerfReport"), 0.0f, [](float)
+				{
+					FinishPerfReport();
+					return false;
+				});
+			}
+		});
+
+		const TSharedRef<const TArray<float>> Points = MakeShared<const TArray<float>>(ImGuiBenchmark::MakeSineWave(NumPlotPoints));
+		FImGuiPanel Panel;
+		Panel.Draw = [Points, NumWindows, NumRows]()
+		{
+			for (int32 Window = 0; Window < NumWindows; ++Window)
+			{
+				char Name[32];
+				ImFormatString(Name, sizeof(Name), "Perf Report %d", Window);
+				if (ImGui::Begin(Name))
+				{
+					for (int32 Row = 0; Row < NumRows; ++Row)
+					{
+						ImGui::Text("Row %d", Row);
+					}
+					if (Points->Num() > 0 && ImPlot::BeginPlot("Plot"))
+					{
+						ImPlot::PlotLine("Values", Points->GetData(), Points->Num());
+						ImPlot::EndPlot();
+					}
+				}
+				ImGui::End();
+			}
+		};
+		Subsystem->RegisterPanel(PerfReportPanel, MoveTemp(Panel));
+	})
+);
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FImGuiPerfReportTest, "UnrealImGuiDocker.PerfReport",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Text heavy, plot heavy and many windows variants of ImGui.PerfReport
+void FImGuiPerfReportTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	OutBeautifiedNames.Add(TEXT("Text"));
+	OutTestCommands.Add(TEXT("Frames=60 Windows=4 Rows=1000 PlotPoints=0"));
+	OutBeautifiedNames.Add(TEXT("Plots"));
+	OutTestCommands.Add(TEXT("Frames=60 Windows=4 Rows=10 PlotPoints=100000"));
+	OutBeautifiedNames.Add(TEXT("Windows"));
+	OutTestCommands.Add(TEXT("Frames=60 Windows=50 Rows=20 PlotPoints=1000"));
+}
+
+// Records a report over the next frames and checks it was written
+bool FImGuiPerfReportTest::RunTest(const FString& Parameters)
+{
+	if (!TestNull(TEXT("Perf report already recording"), GImGuiPerfReport.Get()))
+	{
+		return false;
+	}
+
+	GImGuiLastPerfReportPath.Reset();
+	GEngine->Exec(nullptr, *FString::Printf(TEXT("ImGui.PerfReport %s"), *Parameters));
+	if (!TestNotNull(TEXT("Perf report recording"), GImGuiPerfReport.Get()))
+	{
+		return false;
+	}
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([]()
+	{
+		return !GImGuiPerfReport;
+	}));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this]()
+	{
+		TestTrue(TEXT("Perf report written"), !GImGuiLastPerfReportPath.IsEmpty() && FPaths::FileExists(GImGuiLastPerfReportPath));
+		return true;
+	}));
+	return true;
+}
+
+#endif
+
+#endif
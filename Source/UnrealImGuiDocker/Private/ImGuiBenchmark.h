@@ -0,0 +1,87 @@
+﻿// Copyright Donatien Rabiller. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// ImGui.Benchmark, ImGui.PerfReport and the allocation counter they use are development tools
+#define WITH_IMGUI_BENCHMARK (!UE_BUILD_SHIPPING)
+
+class FJsonObject;
+
+// Frame statistics of one scripted scene built in a headless ImGui context
+struct FImGuiBenchmarkResult
+{
+	FString Scene;
+	int32 Frames = 0;
+	double MeanFrameTime = 0.0; // Seconds spent in NewFrame, the scene and Render
+	double MinFrameTime = 0.0;
+	double MaxFrameTime = 0.0;
+	double AllocationsPerFrame = 0.0; // Calls to the ImGui allocator
+	double AllocatedBytesPerFrame = 0.0;
+	int32 Vertices = 0; // Draw data of the last frame
+	int32 Indices = 0;
+	int32 DrawCmds = 0;
+	int64 SlateBytes = 0; // Vertex and index bytes a canvas hands to Slate for the last frame, one vertex range per command
+	int64 SlateBytesWithoutRanges = 0; // Same with the whole draw list vertex buffer handed to Slate for every command
+};
+
+// Interop code timed while ImGui.PerfReport records
+enum class EImGuiPerfTimer : uint8
+{
+	TickImGui,
+	DrawDataSet,
+	CanvasPaint,
+	Num
+};
+
+#if WITH_IMGUI_BENCHMARK
+
+// Adds the game thread time of its lifetime to Timer when a perf report is recording
+class FImGuiPerfScope
+{
+public:
+	explicit FImGuiPerfScope(EImGuiPerfTimer InTimer);
+	~FImGuiPerfScope();
+
+private:
+	EImGuiPerfTimer Timer;
+	double StartTime;
+};
+
+#else
+
+class FImGuiPerfScope
+{
+public:
+	explicit FImGuiPerfScope(EImGuiPerfTimer InTimer) {}
+};
+
+#endif
+
+#if WITH_IMGUI_BENCHMARK
+
+namespace ImGuiBenchmark
+{
+
+// Runs every scene whose name contains Filter (all of them when empty) on the calling thread. Nothing is rendered, the
+// scenes go through the same ImGui and ImPlot code and imconfig.h as the plugin up to ImGui::Render
+TArray<FImGuiBenchmarkResult> Run(const FString& Filter, int32 Frames);
+
+// Results as JSON, each scene compared with the scene of the same name in Baseline when there is one and Baseline is
+// comparable
+TSharedRef<FJsonObject> ToJson(TConstArrayView<FImGuiBenchmarkResult> Results, const TSharedPtr<FJsonObject>& Baseline);
+
+// Results ImGui.Benchmark SaveBaseline writes and the benchmark is compared against, under the project Saved directory.
+// @NOTE: Resources/ImGuiBenchmarkBaseline.json is the baseline of the standalone build in Benchmark/, not this one
+FString GetBaselinePath();
+
+// Engine version and build configuration, the "Build" field of the results
+FString GetBuildName();
+
+// Whether Baseline was written by the same build, frame times of other builds can't be compared
+bool IsComparable(const TSharedPtr<FJsonObject>& Baseline);
+
+}
+
+#endif
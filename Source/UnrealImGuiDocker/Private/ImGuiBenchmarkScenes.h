@@ -0,0 +1,240 @@
+﻿// Copyright Donatien Rabiller. All rights reserved.
+
+#pragma once
+
+// Scenes of ImGui.Benchmark and the allocation counter they're measured with
+// @NOTE: Only depends on ImGui, ImPlot and the standard library, Benchmark/CMakeLists.txt builds the same scenes with
+// the same imconfig.h outside of UBT
+
+#include <cmath>
+#include <cstdint>
+#include <implot.h>
+
+#include "imgui.h"
+#include "imgui_internal.h"
+
+namespace ImGuiBenchmarkScenes
+{
+
+static constexpr int WarmupFrames = 5;
+static const ImVec2 DisplaySize = {1920.0f, 1080.0f};
+
+// Counts the allocations ImGui makes while Context is current, other contexts of the process aren't counted. Installed
+// once before any context is created and never removed, it forwards to the allocator it replaced
+struct FAllocationCounter
+{
+	ImGuiContext* Context = nullptr;
+	int64_t NumAllocations = 0;
+	int64_t NumAllocatedBytes = 0;
+
+	ImGuiMemAllocFunc AllocFunc = nullptr;
+	ImGuiMemFreeFunc FreeFunc = nullptr;
+	void* AllocatorUserData = nullptr;
+};
+
+inline FAllocationCounter GAllocationCounter;
+
+inline void* CountingAlloc(size_t Size, void* UserData)
+{
+	IM_UNUSED(UserData);
+	if (GAllocationCounter.Context && GAllocationCounter.Context == ImGui::GetCurrentContext())
+	{
+		GAllocationCounter.NumAllocations++;
+		GAllocationCounter.NumAllocatedBytes += Size;
+	}
+	return GAllocationCounter.AllocFunc(Size, GAllocationCounter.AllocatorUserData);
+}
+
+inline void CountingFree(void* Ptr, void* UserData)
+{
+	IM_UNUSED(UserData);
+	GAllocationCounter.FreeFunc(Ptr, GAllocationCounter.AllocatorUserData);
+}
+
+inline void InstallAllocationCounter()
+{
+	if (!GAllocationCounter.AllocFunc)
+	{
+		ImGui::GetAllocatorFunctions(&GAllocationCounter.AllocFunc, &GAllocationCounter.FreeFunc, &GAllocationCounter.AllocatorUserData);
+		ImGui::SetAllocatorFunctions(&CountingAlloc, &CountingFree);
+	}
+}
+
+inline void BeginFullscreenWindow(const char* Name)
+{
+	ImGui::SetNextWindowPos({0.0f, 0.0f});
+	ImGui::SetNextWindowSize(DisplaySize);
+	ImGui::Begin(Name, nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoDocking);
+}
+
+inline void DrawTable(int NumRows, bool bClipped)
+{
+	BeginFullscreenWindow("Table");
+	constexpr int NumColumns = 8;
+	if (ImGui::BeginTable("Rows", NumColumns, ImGuiTableFlags_ScrollY | ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable))
+	{
+		ImGui::TableSetupScrollFreeze(0, 1);
+		for (int Column = 0; Column < NumColumns; ++Column)
+		{
+			ImGui::TableSetupColumn("Column");
+		}
+		ImGui::TableHeadersRow();
+
+		auto DrawRow = [](int Row)
+		{
+			ImGui::TableNextRow();
+			for (int Column = 0; Column < NumColumns; ++Column)
+			{
+				ImGui::TableNextColumn();
+				ImGui::Text("Row %d Column %d", Row, Column);
+			}
+		};
+
+		if (bClipped)
+		{
+			ImGuiListClipper Clipper;
+			Clipper.Begin(NumRows);
+			while (Clipper.Step())
+			{
+				for (int Row = Clipper.DisplayStart; Row < Clipper.DisplayEnd; ++Row)
+				{
+					DrawRow(Row);
+				}
+			}
+		}
+		else
+		{
+			for (int Row = 0; Row < NumRows; ++Row)
+			{
+				DrawRow(Row);
+			}
+		}
+		ImGui::EndTable();
+	}
+	ImGui::End();
+}
+
+inline void DrawDockingLayout(int NumWindows)
+{
+	BeginFullscreenWindow("Dock Host");
+	const ImGuiID DockSpaceId = ImGui::GetID("DockSpace");
+	if (!ImGui::DockBuilderGetNode(DockSpaceId))
+	{
+		// 4 areas with a quarter of the windows tabbed in each
+		ImGui::DockBuilderAddNode(DockSpaceId, ImGuiDockNodeFlags_DockSpace);
+		ImGui::DockBuilderSetNodeSize(DockSpaceId, DisplaySize);
+		ImGuiID Left, Right, TopLeft, BottomLeft, TopRight, BottomRight;
+		ImGui::DockBuilderSplitNode(DockSpaceId, ImGuiDir_Left, 0.5f, &Left, &Right);
+		ImGui::DockBuilderSplitNode(Left, ImGuiDir_Up, 0.5f, &TopLeft, &BottomLeft);
+		ImGui::DockBuilderSplitNode(Right, ImGuiDir_Up, 0.5f, &TopRight, &BottomRight);
+		const ImGuiID Areas[] = {TopLeft, BottomLeft, TopRight, BottomRight};
+		for (int Index = 0; Index < NumWindows; ++Index)
+		{
+			char Name[32];
+			ImFormatString(Name, sizeof(Name), "Docked %d", Index);
+			ImGui::DockBuilderDockWindow(Name, Areas[Index % IM_ARRAYSIZE(Areas)]);
+		}
+		ImGui::DockBuilderFinish(DockSpaceId);
+	}
+	ImGui::DockSpace(DockSpaceId);
+	ImGui::End();
+
+	for (int Index = 0; Index < NumWindows; ++Index)
+	{
+		char Name[32];
+		ImFormatString(Name, sizeof(Name), "Docked %d", Index);
+		if (ImGui::Begin(Name))
+		{
+			for (int Line = 0; Line < 20; ++Line)
+			{
+				ImGui::Text("Line %d", Line);
+			}
+			ImGui::Button("Button");
+		}
+		ImGui::End();
+	}
+}
+
+inline void DrawPlot(const float* Values, int NumValues)
+{
+	BeginFullscreenWindow("Plot");
+	if (ImPlot::BeginPlot("Line", {-1.0f, -1.0f}))
+	{
+		ImPlot::SetupAxes("X", "Y", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+		ImPlot::PlotLine("Values", Values, NumValues);
+		ImPlot::EndPlot();
+	}
+	ImGui::End();
+}
+
+inline void DrawScatter(const float* Values, int NumValues)
+{
+	BeginFullscreenWindow("Scatter");
+	if (ImPlot::BeginPlot("Scatter", {-1.0f, -1.0f}))
+	{
+		ImPlot::SetupAxes("X", "Y", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+		// Filled squares without outline, 4 vertices per point
+		ImPlot::SetNextMarkerStyle(ImPlotMarker_Square, 1.0f, IMPLOT_AUTO_COL, 0.0f);
+		ImPlot::PlotScatter("Values", Values, NumValues);
+		ImPlot::EndPlot();
+	}
+	ImGui::End();
+}
+
+inline void MakeSineWave(float* Values, int NumValues)
+{
+	for (int Index = 0; Index < NumValues; ++Index)
+	{
+		Values[Index] = sinf(Index * 0.01f);
+	}
+}
+
+// Scenes whose frames are too long to be run as many times as the others divide the frame count. Draw gets NumValues
+// points of a sine wave
+struct FScene
+{
+	const char* Name;
+	int FrameDivisor;
+	int NumValues;
+	void (*Draw)(const float* Values, int NumValues);
+};
+
+inline const FScene Scenes[] = {
+	{"Table.Clipped100k", 1, 0, [](const float*, int) { DrawTable(100000, true); }},
+	{"Table.Unclipped2k", 1, 0, [](const float*, int) { DrawTable(2000, false); }},
+	{"Docking.16Windows", 1, 0, [](const float*, int) { DrawDockingLayout(16); }},
+	{"ImPlot.Line1e3", 1, 1000, &DrawPlot},
+	{"ImPlot.Line1e5", 1, 100000, &DrawPlot},
+	{"ImPlot.Line1e7", 10, 10000000, &DrawPlot},
+	{"ImPlot.Scatter2M", 10, 2000000, &DrawScatter},
+};
+
+// Bytes SImGuiCanvas submits to Slate for DrawData, see FImGuiCachedDrawList::Build. Commands aren't coalesced here
+inline void CountSlateBytes(const ImDrawData& DrawData, size_t VertexSize, size_t IndexSize, int64_t& OutSlateBytes, int64_t& OutSlateBytesWithoutRanges)
+{
+	for (const ImDrawList* DrawList : DrawData.CmdLists)
+	{
+		for (const ImDrawCmd& DrawCmd : DrawList->CmdBuffer)
+		{
+			if (DrawCmd.ElemCount == 0 || DrawCmd.UserCallback)
+			{
+				continue;
+			}
+
+			const ImDrawIdx* CmdIndices = DrawList->IdxBuffer.Data + DrawCmd.IdxOffset;
+			ImDrawIdx MinIndex = CmdIndices[0];
+			ImDrawIdx MaxIndex = CmdIndices[0];
+			for (unsigned int ElemIndex = 1; ElemIndex < DrawCmd.ElemCount; ++ElemIndex)
+			{
+				MinIndex = ImMin(MinIndex, CmdIndices[ElemIndex]);
+				MaxIndex = ImMax(MaxIndex, CmdIndices[ElemIndex]);
+			}
+
+			const int64_t IndexBytes = (int64_t)DrawCmd.ElemCount * IndexSize;
+			OutSlateBytes += (int64_t)(MaxIndex - MinIndex + 1) * VertexSize + IndexBytes;
+			OutSlateBytesWithoutRanges += (int64_t)DrawList->VtxBuffer.Size * VertexSize + IndexBytes;
+		}
+	}
+}
+
+}
@@ -8,4 +8,4 @@
 #include "implot.cpp"
 #include "implot_demo.cpp"
 #include "implot_items.cpp"
-// ReSharper enable CppUnusedIncludeDirective
\ No newline at end of file
+// ReSharper enable CppUnusedIncludeDirective
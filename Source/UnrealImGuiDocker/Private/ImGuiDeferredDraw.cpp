@@ -0,0 +1,394 @@
+﻿// Copyright Donatien Rabiller. All rights reserved.
+
+#include "ImGuiDeferredDraw.h"
+
+#include <implot.h>
+
+#include "imgui.h"
+#include "Algo/StableSort.h"
+#include "Async/Async.h"
+#include "Containers/LockFreeList.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+enum class EImGuiDeferredCommand : uint8
+{
+	Text,
+	Line,
+	Rect,
+	Circle,
+	PlotLine,
+};
+
+struct FImGuiDeferredCommand
+{
+	EImGuiDeferredCommand Type;
+	bool bFilled;
+	ImU32 Color;
+	float Thickness;
+	FVector2f A; // Line start, rect min or circle center
+	FVector2f B; // Line end, rect max or circle radius in X
+	FName Window;
+	FName Plot;
+	FName Series;
+	// UTF-8 names in Strings, see FCommandList::AddName
+	int32 WindowOffset;
+	int32 PlotOffset;
+	int32 SeriesOffset;
+	int32 DataOffset; // First character in Strings or first value in Values
+	int32 DataCount;
+};
+
+struct FImGuiDeferredDraw::FCommandList
+{
+	TWeakObjectPtr<const UWorld> World; // @NOTE: Only compared against world contexts, a stale world drops the list
+	bool bHasWorld = false;
+	uint64 SubmitFrame = 0; // GFrameCounter when submitted
+	TArray<FImGuiDeferredCommand> Commands;
+	TArray<UTF8CHAR> Strings; // Null terminated texts and names
+	TMap<FName, int32> NameOffsets; // Names are converted to UTF-8 once per list
+
+	TArray<float> Values;
+
+	int32 AddName(FName Name);
+	const char* GetString(int32 Offset) const { return reinterpret_cast<const char*>(&Strings[Offset]); }
+};
+
+int32 FImGuiDeferredDraw::FCommandList::AddName(FName Name)
+{
+	if (const int32* Offset = NameOffsets.Find(Name))
+	{
+		return *Offset;
+	}
+
+	TStringBuilder<FName::StringBufferSize> NameString;
+	Name.AppendString(NameString);
+	const FTCHARToUTF8 Utf8Name(NameString.GetData(), NameString.Len());
+	const int32 Offset = Strings.Num();
+	Strings.Append(reinterpret_cast<const UTF8CHAR*>(Utf8Name.Get()), Utf8Name.Length());
+	Strings.Add(UTF8CHAR('\0'));
+	NameOffsets.Add(Name, Offset);
+	return Offset;
+}
+
+// Lists submitted for a world the current context doesn't draw are kept for that many frames at most
+static constexpr uint64 GMaxPendingFrames = 60;
+
+static TLockFreePointerListUnordered<FImGuiDeferredDraw::FCommandList, PLATFORM_CACHE_LINE_SIZE> GSubmittedCommandLists;
+static TArray<FImGuiDeferredDraw::FCommandList*> GPendingCommandLists; // Submitted lists not replayed yet, oldest first
+
+static FORCEINLINE ImU32 ToImGuiColor(FColor Color)
+{
+	return IM_COL32(Color.R, Color.G, Color.B, Color.A);
+}
+
+static FORCEINLINE ImVec2 ToImVec2(const FVector2f& Vector)
+{
+	return ImVec2{Vector.X, Vector.Y};
+}
+
+static FImGuiDeferredCommand& AddCommand(FImGuiDeferredDraw::FCommandList*& Commands, EImGuiDeferredCommand Type)
+{
+	if (!Commands)
+	{
+		Commands = new FImGuiDeferredDraw::FCommandList();
+	}
+
+	FImGuiDeferredCommand& Command = Commands->Commands.AddZeroed_GetRef();
+	Command.Type = Type;
+	return Command;
+}
+
+FImGuiDeferredDraw::FImGuiDeferredDraw(const UWorld* InWorld)
+	: World(InWorld)
+{
+}
+
+FImGuiDeferredDraw::~FImGuiDeferredDraw()
+{
+	Submit();
+}
+
+void FImGuiDeferredDraw::Text(FName Window, FStringView InText, FColor Color)
+{
+	const FTCHARToUTF8 Utf8Text(InText.GetData(), InText.Len());
+	FImGuiDeferredCommand& Command = AddCommand(Commands, EImGuiDeferredCommand::Text);
+	Command.Color = ToImGuiColor(Color);
+	Command.Window = Window;
+	Command.WindowOffset = Commands->AddName(Window);
+	Command.DataOffset = Commands->Strings.Num();
+	Command.DataCount = Utf8Text.Length();
+	Commands->Strings.Append(reinterpret_cast<const UTF8CHAR*>(Utf8Text.Get()), Utf8Text.Length());
+	Commands->Strings.Add(UTF8CHAR('\0'));
+}
+
+void FImGuiDeferredDraw::Line(const FVector2f& From, const FVector2f& To, FColor Color, float Thickness)
+{
+	FImGuiDeferredCommand& Command = AddCommand(Commands, EImGuiDeferredCommand::Line);
+	Command.Color = ToImGuiColor(Color);
+	Command.Thickness = Thickness;
+	Command.A = From;
+	Command.B = To;
+}
+
+void FImGuiDeferredDraw::Rect(const FVector2f& Min, const FVector2f& Max, FColor Color, float Thickness, bool bFilled)
+{
+	FImGuiDeferredCommand& Command = AddCommand(Commands, EImGuiDeferredCommand::Rect);
+	Command.bFilled = bFilled;
+	Command.Color = ToImGuiColor(Color);
+	Command.Thickness = Thickness;
+	Command.A = Min;
+	Command.B = Max;
+}
+
+void FImGuiDeferredDraw::Circle(const FVector2f& Center, float Radius, FColor Color, float Thickness, bool bFilled)
+{
+	FImGuiDeferredCommand& Command = AddCommand(Commands, EImGuiDeferredCommand::Circle);
+	Command.bFilled = bFilled;
+	Command.Color = ToImGuiColor(Color);
+	Command.Thickness = Thickness;
+	Command.A = Center;
+	Command.B = {Radius, 0.0f};
+}
+
+void FImGuiDeferredDraw::PlotLine(FName Window, FName Plot, FName Series, TConstArrayView<float> Values)
+{
+	FImGuiDeferredCommand& Command = AddCommand(Commands, EImGuiDeferredCommand::PlotLine);
+	Command.Window = Window;
+	Command.Plot = Plot;
+	Command.Series = Series;
+	Command.WindowOffset = Commands->AddName(Window);
+	Command.PlotOffset = Commands->AddName(Plot);
+	Command.SeriesOffset = Commands->AddName(Series);
+	Command.DataOffset = Commands->Values.Num();
+	Command.DataCount = Values.Num();
+	Commands->Values.Append(Values.GetData(), Values.Num());
+}
+
+void FImGuiDeferredDraw::Submit()
+{
+	if (Commands)
+	{
+		Commands->World = World;
+		Commands->bHasWorld = World != nullptr;
+		Commands->SubmitFrame = GFrameCounter;
+		GSubmittedCommandLists.Push(Commands);
+		Commands = nullptr;
+	}
+}
+
+int32 FImGuiDeferredDraw::ReplaySubmitted(TFunctionRef<bool(const UWorld*)> WorldFilter)
+{
+	check(IsInGameThread());
+
+	TArray<FCommandList*> SubmittedLists;
+	GSubmittedCommandLists.PopAll(SubmittedLists);
+	for (int32 ListIdx = SubmittedLists.Num() - 1; ListIdx >= 0; --ListIdx) // @NOTE: PopAll returns the most recent first
+	{
+		GPendingCommandLists.Add(SubmittedLists[ListIdx]);
+	}
+
+	TArray<FCommandList*> ReplayedLists;
+	for (int32 ListIdx = 0; ListIdx < GPendingCommandLists.Num();)
+	{
+		FCommandList* List = GPendingCommandLists[ListIdx];
+		const UWorld* ListWorld = List->World.Get();
+		if ((List->bHasWorld && !ListWorld) || GFrameCounter - List->SubmitFrame > GMaxPendingFrames)
+		{
+			delete List;
+			GPendingCommandLists.RemoveAt(ListIdx, 1, false);
+		}
+		else if (WorldFilter(ListWorld))
+		{
+			ReplayedLists.Add(List);
+			GPendingCommandLists.RemoveAt(ListIdx, 1, false);
+		}
+		else
+		{
+			++ListIdx;
+		}
+	}
+
+	struct FPlotSeries
+	{
+		const FCommandList* List;
+		const FImGuiDeferredCommand* Command;
+		const float* Values;
+	};
+	TArray<FPlotSeries> PlotSeries;
+
+	int32 NumReplayed = 0;
+	ImDrawList* BackgroundDrawList = ImGui::GetBackgroundDrawList();
+	for (const FCommandList* List : ReplayedLists)
+	{
+		for (const FImGuiDeferredCommand& Command : List->Commands)
+		{
+			switch (Command.Type)
+			{
+			case EImGuiDeferredCommand::Text:
+				ImGui::Begin(List->GetString(Command.WindowOffset));
+				ImGui::PushStyleColor(ImGuiCol_Text, Command.Color);
+				ImGui::TextUnformatted(List->GetString(Command.DataOffset), List->GetString(Command.DataOffset) + Command.DataCount);
+				ImGui::PopStyleColor();
+				ImGui::End();
+				break;
+			case EImGuiDeferredCommand::Line:
+				BackgroundDrawList->AddLine(ToImVec2(Command.A), ToImVec2(Command.B), Command.Color, Command.Thickness);
+				break;
+			case EImGuiDeferredCommand::Rect:
+				if (Command.bFilled)
+				{
+					BackgroundDrawList->AddRectFilled(ToImVec2(Command.A), ToImVec2(Command.B), Command.Color);
+				}
+				else
+				{
+					BackgroundDrawList->AddRect(ToImVec2(Command.A), ToImVec2(Command.B), Command.Color, 0.0f, 0, Command.Thickness);
+				}
+				break;
+			case EImGuiDeferredCommand::Circle:
+				if (Command.bFilled)
+				{
+					BackgroundDrawList->AddCircleFilled(ToImVec2(Command.A), Command.B.X, Command.Color);
+				}
+				else
+				{
+					BackgroundDrawList->AddCircle(ToImVec2(Command.A), Command.B.X, Command.Color, 0, Command.Thickness);
+				}
+				break;
+			case EImGuiDeferredCommand::PlotLine:
+				PlotSeries.Add({List, &Command, List->Values.GetData() + Command.DataOffset});
+				break;
+			}
+			NumReplayed++;
+		}
+	}
+
+	// @NOTE: A plot can only be begun once per frame, so series are grouped by window and plot across every list
+	Algo::StableSortBy(PlotSeries, [](const FPlotSeries& Series)
+	{
+		return TPair<FName, FName>(Series.Command->Window, Series.Command->Plot);
+	}, [](const TPair<FName, FName>& A, const TPair<FName, FName>& B)
+	{
+		return A.Key.FastLess(B.Key) || (A.Key == B.Key && A.Value.FastLess(B.Value));
+	});
+	for (int32 SeriesIdx = 0; SeriesIdx < PlotSeries.Num();)
+	{
+		const FCommandList& FirstList = *PlotSeries[SeriesIdx].List;
+		const FImGuiDeferredCommand& First = *PlotSeries[SeriesIdx].Command;
+		ImGui::Begin(FirstList.GetString(First.WindowOffset));
+		const bool bPlotOpen = ImPlot::BeginPlot(FirstList.GetString(First.PlotOffset));
+		for (; SeriesIdx < PlotSeries.Num()
+		       && PlotSeries[SeriesIdx].Command->Window == First.Window
+		       && PlotSeries[SeriesIdx].Command->Plot == First.Plot; ++SeriesIdx)
+		{
+			if (bPlotOpen)
+			{
+				const FImGuiDeferredCommand& Series = *PlotSeries[SeriesIdx].Command;
+				ImPlot::PlotLine(PlotSeries[SeriesIdx].List->GetString(Series.SeriesOffset), PlotSeries[SeriesIdx].Values, Series.DataCount);
+			}
+		}
+		if (bPlotOpen)
+		{
+			ImPlot::EndPlot();
+		}
+		ImGui::End();
+	}
+
+	for (FCommandList* List : ReplayedLists)
+	{
+		delete List;
+	}
+
+	return NumReplayed;
+}
+
+void FImGuiDeferredDraw::DiscardSubmitted()
+{
+	check(IsInGameThread());
+
+	TArray<FCommandList*> SubmittedLists;
+	GSubmittedCommandLists.PopAll(SubmittedLists);
+	SubmittedLists.Append(MoveTemp(GPendingCommandLists));
+	GPendingCommandLists.Empty();
+	for (FCommandList* List : SubmittedLists)
+	{
+		delete List;
+	}
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FImGuiDeferredDrawStressTest, "UnrealImGuiDocker.DeferredDraw.Stress",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// 16 threads record and submit while the game thread replays into a context of its own, every command must be
+// replayed exactly once
+bool FImGuiDeferredDrawStressTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumProducers = 16;
+	constexpr int32 NumLists = 200;
+	constexpr int32 NumCommandsPerList = 5;
+
+	ImGuiContext* PreviousContext = ImGui::GetCurrentContext();
+	ImPlotContext* PreviousPlotContext = ImPlot::GetCurrentContext();
+	ImGuiContext* Context = ImGui::CreateContext();
+	ImPlotContext* PlotContext = ImPlot::CreateContext();
+	ImGui::SetCurrentContext(Context);
+	ImPlot::SetCurrentContext(PlotContext);
+
+	ImGuiIO& IO = ImGui::GetIO();
+	IO.IniFilename = nullptr;
+	IO.DisplaySize = ImVec2(1280.0f, 720.0f);
+	unsigned char* Pixels;
+	int Width, Height;
+	IO.Fonts->GetTexDataAsRGBA32(&Pixels, &Width, &Height);
+
+	// Leftovers from earlier frames would skew the count
+	DiscardSubmitted();
+
+	std::atomic<int32> NumProducersDone = 0;
+	TArray<TFuture<void>> Producers;
+	for (int32 ProducerIdx = 0; ProducerIdx < NumProducers; ++ProducerIdx)
+	{
+		Producers.Add(Async(EAsyncExecution::Thread, [ProducerIdx, &NumProducersDone]()
+		{
+			const FName Window = *FString::Printf(TEXT("Stress %d"), ProducerIdx % 4);
+			const FName Series = *FString::Printf(TEXT("Producer %d"), ProducerIdx);
+			const float Values[] = {0.0f, 1.0f, 0.5f, 2.0f};
+			for (int32 ListIdx = 0; ListIdx < NumLists; ++ListIdx)
+			{
+				FImGuiDeferredDraw Draw;
+				Draw.Text(Window, FString::Printf(TEXT("%d %d"), ProducerIdx, ListIdx));
+				Draw.Line({0.0f, 0.0f}, {100.0f, 100.0f}, FColor::Red);
+				Draw.Rect({10.0f, 10.0f}, {20.0f, 20.0f}, FColor::Green, 1.0f, true);
+				Draw.Circle({50.0f, 50.0f}, 10.0f, FColor::Blue);
+				Draw.PlotLine(Window, TEXT("Plot"), Series, Values);
+			}
+			++NumProducersDone;
+		}));
+	}
+
+	int32 NumReplayed = 0;
+	bool bProducersDone = false;
+	while (!bProducersDone)
+	{
+		// @NOTE: Read before replaying so the last frame sees every submitted list
+		bProducersDone = NumProducersDone == NumProducers;
+		ImGui::NewFrame();
+		NumReplayed += ReplaySubmitted([](const UWorld*) { return true; });
+		ImGui::Render();
+	}
+	for (TFuture<void>& Producer : Producers)
+	{
+		Producer.Wait();
+	}
+
+	ImPlot::DestroyContext(PlotContext);
+	ImGui::DestroyContext(Context);
+	ImGui::SetCurrentContext(PreviousContext);
+	ImPlot::SetCurrentContext(PreviousPlotContext);
+
+	return TestEqual(TEXT("Replayed commands"), NumReplayed, NumProducers * NumLists * NumCommandsPerList);
+}
+
+#endif
@@ -0,0 +1,317 @@
+﻿// Copyright Donatien Rabiller. All rights reserved.
+
+#include "ImGuiDrawCapture.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/Compression.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+static constexpr uint32 ImDrawMagic = 0x57524449; // "IDRW"
+static constexpr uint32 ImDrawVersion = 2;
+
+// FCompression takes 32 bit sizes, the frames are compressed in blocks of this size
+static constexpr int64 CompressionBlockSize = 64 * 1024 * 1024;
+// Upper bound of the zlib compression ratio, a header claiming more than this is corrupted
+static constexpr int64 MaxCompressionRatio = 1032;
+
+// Smallest serialized size of each part of a frame, see FImGuiDrawCaptureWriter::AddFrame
+static constexpr int64 MinViewportSize = sizeof(ImGuiID) + 3 * sizeof(ImVec2) + sizeof(int32);
+static constexpr int64 MinDrawListSize = 4 * sizeof(int32);
+static constexpr int64 DrawCmdSize = sizeof(ImVec4) + sizeof(int32) + 3 * sizeof(uint32);
+
+static void SerializeVec2(FArchive& Ar, ImVec2& Vec)
+{
+	Ar << Vec.x << Vec.y;
+}
+
+// Whether the loading archive holds Num elements of at least ElementSize bytes past its position
+static bool IsValidCount(FArchive& Ar, int64 Num, int64 ElementSize)
+{
+	return !Ar.IsError() && Num >= 0 && Num <= (Ar.TotalSize() - Ar.Tell()) / ElementSize;
+}
+
+// Header shared by the writer and the reader, the frames follow as compressed blocks
+static bool SerializeHeader(FArchive& Ar, TArray<int64>& FrameOffsets, TArray<FString>& TextureNames, int64& UncompressedSize)
+{
+	uint32 Magic = ImDrawMagic;
+	uint32 Version = ImDrawVersion;
+	uint32 VertexSize = sizeof(ImDrawVert);
+	uint32 IndexSize = sizeof(ImDrawIdx);
+	Ar << Magic << Version << VertexSize << IndexSize;
+	if (Ar.IsError() || Magic != ImDrawMagic || Version != ImDrawVersion || VertexSize != sizeof(ImDrawVert) || IndexSize != sizeof(ImDrawIdx))
+	{
+		return false;
+	}
+
+	int32 NumFrames = FrameOffsets.Num();
+	Ar << NumFrames;
+	if (Ar.IsLoading())
+	{
+		if (!IsValidCount(Ar, NumFrames, sizeof(int64)))
+		{
+			return false;
+		}
+		FrameOffsets.SetNumUninitialized(NumFrames);
+	}
+	for (int64& FrameOffset : FrameOffsets)
+	{
+		Ar << FrameOffset;
+	}
+
+	int32 NumTextures = TextureNames.Num();
+	Ar << NumTextures;
+	if (Ar.IsLoading())
+	{
+		if (!IsValidCount(Ar, NumTextures, sizeof(int32)))
+		{
+			return false;
+		}
+		TextureNames.SetNum(NumTextures);
+	}
+	for (FString& TextureName : TextureNames)
+	{
+		Ar << TextureName;
+	}
+
+	Ar << UncompressedSize;
+	if (Ar.IsError() || UncompressedSize < 0)
+	{
+		return false;
+	}
+
+	if (Ar.IsLoading())
+	{
+		if (UncompressedSize / MaxCompressionRatio > Ar.TotalSize() - Ar.Tell())
+		{
+			return false;
+		}
+		for (int64 FrameOffset : FrameOffsets)
+		{
+			// Every frame starts with its viewport count
+			if (FrameOffset < 0 || FrameOffset > UncompressedSize - (int64)sizeof(int32))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void FImGuiDrawCaptureWriter::AddFrame(const ImVector<ImGuiViewport*>& Viewports, TFunctionRef<FString(ImTextureID)> GetTextureName)
+{
+	FMemoryWriter64 Ar(FrameData);
+	Ar.Seek(FrameData.Num());
+	FrameOffsets.Add(FrameData.Num());
+
+	int32 NumViewports = 0;
+	for (const ImGuiViewport* Viewport : Viewports)
+	{
+		NumViewports += Viewport->DrawData && Viewport->DrawData->Valid;
+	}
+	Ar << NumViewports;
+
+	for (const ImGuiViewport* Viewport : Viewports)
+	{
+		ImDrawData* DrawData = Viewport->DrawData;
+		if (!DrawData || !DrawData->Valid)
+		{
+			continue;
+		}
+
+		ImGuiID ViewportId = Viewport->ID;
+		Ar << ViewportId;
+		SerializeVec2(Ar, DrawData->DisplayPos);
+		SerializeVec2(Ar, DrawData->DisplaySize);
+		SerializeVec2(Ar, DrawData->FramebufferScale);
+		Ar << DrawData->CmdListsCount;
+
+		for (ImDrawList* DrawList : DrawData->CmdLists)
+		{
+			int32 Flags = DrawList->Flags;
+			Ar << Flags;
+			Ar << DrawList->CmdBuffer.Size;
+			for (ImDrawCmd& DrawCmd : DrawList->CmdBuffer)
+			{
+				int32* TextureIndex = TextureIndices.Find(DrawCmd.TextureId);
+				if (!TextureIndex)
+				{
+					TextureIndex = &TextureIndices.Add(DrawCmd.TextureId, TextureNames.Add(GetTextureName(DrawCmd.TextureId)));
+				}
+
+				Ar << DrawCmd.ClipRect.x << DrawCmd.ClipRect.y << DrawCmd.ClipRect.z << DrawCmd.ClipRect.w;
+				Ar << *TextureIndex << DrawCmd.VtxOffset << DrawCmd.IdxOffset << DrawCmd.ElemCount;
+			}
+
+			Ar << DrawList->VtxBuffer.Size;
+			Ar.Serialize(DrawList->VtxBuffer.Data, DrawList->VtxBuffer.size_in_bytes());
+			Ar << DrawList->IdxBuffer.Size;
+			Ar.Serialize(DrawList->IdxBuffer.Data, DrawList->IdxBuffer.size_in_bytes());
+		}
+	}
+}
+
+bool FImGuiDrawCaptureWriter::Save(const FString& FilePath) const
+{
+	const TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Ar)
+	{
+		return false;
+	}
+
+	TArray<int64> Offsets = FrameOffsets;
+	TArray<FString> Names = TextureNames;
+	int64 UncompressedSize = FrameData.Num();
+	if (!SerializeHeader(*Ar, Offsets, Names, UncompressedSize))
+	{
+		return false;
+	}
+
+	TArray<uint8> CompressedBlock;
+	for (int64 BlockStart = 0; BlockStart < FrameData.Num(); BlockStart += CompressionBlockSize)
+	{
+		const int32 BlockSize = (int32)FMath::Min(CompressionBlockSize, FrameData.Num() - BlockStart);
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, BlockSize);
+		CompressedBlock.SetNumUninitialized(CompressedSize);
+		if (!FCompression::CompressMemory(NAME_Zlib, CompressedBlock.GetData(), CompressedSize, FrameData.GetData() + BlockStart, BlockSize))
+		{
+			return false;
+		}
+		*Ar << CompressedSize;
+		Ar->Serialize(CompressedBlock.GetData(), CompressedSize);
+	}
+	return Ar->Close();
+}
+
+bool FImGuiDrawCaptureReader::Load(const FString& FilePath)
+{
+	const TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*FilePath));
+	int64 UncompressedSize = 0;
+	if (!Ar || !SerializeHeader(*Ar, FrameOffsets, TextureNames, UncompressedSize))
+	{
+		return false;
+	}
+
+	FrameData.SetNumUninitialized(UncompressedSize);
+	TArray<uint8> CompressedBlock;
+	for (int64 BlockStart = 0; BlockStart < UncompressedSize; BlockStart += CompressionBlockSize)
+	{
+		const int32 BlockSize = (int32)FMath::Min(CompressionBlockSize, UncompressedSize - BlockStart);
+		int32 CompressedSize;
+		*Ar << CompressedSize;
+		if (!IsValidCount(*Ar, CompressedSize, 1))
+		{
+			return false;
+		}
+		CompressedBlock.SetNumUninitialized(CompressedSize);
+		Ar->Serialize(CompressedBlock.GetData(), CompressedSize);
+		if (Ar->IsError() || !FCompression::UncompressMemory(NAME_Zlib, FrameData.GetData() + BlockStart, BlockSize, CompressedBlock.GetData(), CompressedSize))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FImGuiDrawCaptureReader::ReadFrame(int32 Frame, TConstArrayView<ImTextureID> Textures, TArray<FImGuiCapturedViewport>& OutViewports) const
+{
+	if (!FrameOffsets.IsValidIndex(Frame))
+	{
+		return false;
+	}
+
+	FMemoryReader64 Ar(FrameData);
+	Ar.Seek(FrameOffsets[Frame]);
+
+	int32 NumViewports;
+	Ar << NumViewports;
+	if (!IsValidCount(Ar, NumViewports, MinViewportSize))
+	{
+		return false;
+	}
+	OutViewports.SetNum(NumViewports);
+
+	for (FImGuiCapturedViewport& Viewport : OutViewports)
+	{
+		ImDrawData& DrawData = Viewport.DrawData;
+		DrawData.Clear();
+		DrawData.Valid = true;
+		Ar << Viewport.ViewportId;
+		SerializeVec2(Ar, DrawData.DisplayPos);
+		SerializeVec2(Ar, DrawData.DisplaySize);
+		SerializeVec2(Ar, DrawData.FramebufferScale);
+
+		int32 NumDrawLists;
+		Ar << NumDrawLists;
+		if (!IsValidCount(Ar, NumDrawLists, MinDrawListSize))
+		{
+			return false;
+		}
+		while (Viewport.DrawLists.Num() < NumDrawLists)
+		{
+			Viewport.DrawLists.Add(new ImDrawList(nullptr));
+		}
+
+		for (int32 DrawListIndex = 0; DrawListIndex < NumDrawLists; ++DrawListIndex)
+		{
+			ImDrawList* DrawList = &Viewport.DrawLists[DrawListIndex];
+			int32 Flags, NumCmds, NumVertices, NumIndices;
+			Ar << Flags << NumCmds;
+			if (!IsValidCount(Ar, NumCmds, DrawCmdSize))
+			{
+				return false;
+			}
+			DrawList->Flags = Flags;
+			DrawList->CmdBuffer.resize(NumCmds);
+			for (ImDrawCmd& DrawCmd : DrawList->CmdBuffer)
+			{
+				int32 TextureIndex;
+				DrawCmd = ImDrawCmd();
+				Ar << DrawCmd.ClipRect.x << DrawCmd.ClipRect.y << DrawCmd.ClipRect.z << DrawCmd.ClipRect.w;
+				Ar << TextureIndex << DrawCmd.VtxOffset << DrawCmd.IdxOffset << DrawCmd.ElemCount;
+				DrawCmd.TextureId = Textures.IsValidIndex(TextureIndex) ? Textures[TextureIndex] : nullptr;
+			}
+
+			Ar << NumVertices;
+			if (!IsValidCount(Ar, NumVertices, sizeof(ImDrawVert)))
+			{
+				return false;
+			}
+			DrawList->VtxBuffer.resize(NumVertices);
+			Ar.Serialize(DrawList->VtxBuffer.Data, DrawList->VtxBuffer.size_in_bytes());
+			Ar << NumIndices;
+			if (!IsValidCount(Ar, NumIndices, sizeof(ImDrawIdx)))
+			{
+				return false;
+			}
+			DrawList->IdxBuffer.resize(NumIndices);
+			Ar.Serialize(DrawList->IdxBuffer.Data, DrawList->IdxBuffer.size_in_bytes());
+			if (Ar.IsError())
+			{
+				return false;
+			}
+
+			// Canvases read the vertices the indices of each command point at
+			for (const ImDrawCmd& DrawCmd : DrawList->CmdBuffer)
+			{
+				if ((uint64)DrawCmd.IdxOffset + DrawCmd.ElemCount > (uint64)NumIndices || DrawCmd.VtxOffset > (uint32)NumVertices)
+				{
+					return false;
+				}
+				for (uint32 ElemIndex = DrawCmd.IdxOffset; ElemIndex < DrawCmd.IdxOffset + DrawCmd.ElemCount; ++ElemIndex)
+				{
+					if ((uint64)DrawCmd.VtxOffset + DrawList->IdxBuffer[ElemIndex] >= (uint64)NumVertices)
+					{
+						return false;
+					}
+				}
+			}
+
+			DrawData.CmdLists.push_back(DrawList);
+			DrawData.CmdListsCount++;
+			DrawData.TotalVtxCount += NumVertices;
+			DrawData.TotalIdxCount += NumIndices;
+		}
+	}
+	return !Ar.IsError();
+}
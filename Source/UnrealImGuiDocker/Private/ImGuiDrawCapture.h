@@ -0,0 +1,49 @@
+﻿// Copyright Donatien Rabiller. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "imgui.h"
+
+// .imdraw files hold the draw data of every viewport of a context over consecutive frames. Textures are referenced by
+// name, so a capture can be replayed without the tools or assets that produced it
+class FImGuiDrawCaptureWriter
+{
+public:
+	// Adds the draw data of the viewports rendered this frame, GetTextureName names the textures the commands use
+	void AddFrame(const ImVector<ImGuiViewport*>& Viewports, TFunctionRef<FString(ImTextureID)> GetTextureName);
+	int32 GetNumFrames() const { return FrameOffsets.Num(); }
+	bool Save(const FString& FilePath) const;
+
+private:
+	TArray64<uint8> FrameData;
+	TArray<int64> FrameOffsets;
+	TArray<FString> TextureNames;
+	TMap<ImTextureID, int32> TextureIndices;
+};
+
+// Captured viewport rebuilt as ImDrawData, the draw lists own the captured buffers
+struct FImGuiCapturedViewport
+{
+	ImGuiID ViewportId = 0;
+	ImDrawData DrawData;
+	TIndirectArray<ImDrawList> DrawLists;
+};
+
+class FImGuiDrawCaptureReader
+{
+public:
+	bool Load(const FString& FilePath);
+	int32 GetNumFrames() const { return FrameOffsets.Num(); }
+	const TArray<FString>& GetTextureNames() const { return TextureNames; }
+
+	// Rebuilds the viewports of Frame, Textures maps the texture names of the file to the texture IDs to draw with.
+	// Returns false when the frame is corrupted, OutViewports are then left partially read.
+	// @NOTE: Draw lists are reused from one call to the next
+	bool ReadFrame(int32 Frame, TConstArrayView<ImTextureID> Textures, TArray<FImGuiCapturedViewport>& OutViewports) const;
+
+private:
+	TArray64<uint8> FrameData;
+	TArray<int64> FrameOffsets;
+	TArray<FString> TextureNames;
+};
@@ -2,55 +2,345 @@
 
 #include "ImGuiSubsystem.h"
 
+#include <atomic>
 #include <implot.h>
 
 #include "imgui.h"
+#include "imgui_internal.h"
+#include "Async/ParallelFor.h"
 #include "Brushes/SlateColorBrush.h"
 #include "Brushes/SlateImageBrush.h"
+#include "Engine/GameViewportClient.h"
 #include "Engine/Texture2D.h"
-
-UE_DISABLE_OPTIMIZATION
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Hash/xxhash.h"
+#include "HAL/FileManager.h"
+#include "ImGuiBenchmark.h"
+#include "ImGuiBenchmarkScenes.h"
+#include "ImGuiDeferredDraw.h"
+#include "ImGuiDrawCapture.h"
+#include "ImGuiShaders.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "PipelineStateCache.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RenderUtils.h"
+#include "RHIStaticStates.h"
+#include "Stats/Stats.h"
+#include "TextureResource.h"
+#include "Trace/Trace.h"
+#include "UObject/StrongObjectPtr.h"
+#include "UnrealImGuiDocker.h"
+#include "Widgets/SInvalidationPanel.h"
+
+DECLARE_STATS_GROUP(TEXT("ImGui"), STATGROUP_ImGui, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw Data Bytes Handed Off"), STAT_ImGui_DrawDataBytes, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Paint Arena Allocations"), STAT_ImGui_PaintArenaAllocations, STATGROUP_ImGui);
+DECLARE_MEMORY_STAT(TEXT("Paint Arena Memory"), STAT_ImGui_PaintArenaMemory, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Slate Element Allocations"), STAT_ImGui_SlateElementAllocations, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw Commands Before Coalescing"), STAT_ImGui_DrawCmdsBeforeCoalescing, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw Commands After Coalescing"), STAT_ImGui_DrawCmdsAfterCoalescing, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bytes Submitted To Slate"), STAT_ImGui_BytesSubmitted, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw Lists Converted"), STAT_ImGui_DrawListsConverted, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw Lists Reused"), STAT_ImGui_DrawListsReused, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw Lists Hashed"), STAT_ImGui_DrawListsHashed, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Canvas Paint Invalidations"), STAT_ImGui_CanvasInvalidations, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Canvas Paint"), STAT_ImGui_CanvasPaint, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Render Thread Draw"), STAT_ImGui_RenderThreadDraw, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw Commands Culled"), STAT_ImGui_DrawCmdsCulled, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw Commands Submitted"), STAT_ImGui_DrawCmdsSubmitted, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Parallel Geometry Conversion"), STAT_ImGui_ParallelConversion, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Frames Rendered"), STAT_ImGui_FramesRendered, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Frames Skipped"), STAT_ImGui_FramesSkipped, STATGROUP_ImGui);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Game Thread Time Saved (ms)"), STAT_ImGui_GameThreadTimeSaved, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Context Tick"), STAT_ImGui_ContextTick, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred Draw Commands Replayed"), STAT_ImGui_DeferredCommandsReplayed, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw Lists"), STAT_ImGui_DrawLists, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Vertices"), STAT_ImGui_Vertices, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Indices"), STAT_ImGui_Indices, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Viewports"), STAT_ImGui_Viewports, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Viewports Skipped"), STAT_ImGui_ViewportsSkipped, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Input Forwarding"), STAT_ImGui_InputForwarding, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Mouse Moves Received"), STAT_ImGui_MouseMovesReceived, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Mouse Moves Forwarded"), STAT_ImGui_MouseMovesForwarded, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Input Events Queued"), STAT_ImGui_InputEventsQueued, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Window Pool Hits"), STAT_ImGui_WindowPoolHits, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Window Pool Misses"), STAT_ImGui_WindowPoolMisses, STATGROUP_ImGui);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Windows"), STAT_ImGui_PooledWindows, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Native Window Calls"), STAT_ImGui_NativeWindowCalls, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Native Window Calls Avoided"), STAT_ImGui_NativeWindowCallsAvoided, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("NewFrame"), STAT_ImGui_NewFrame, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Registered Panels"), STAT_ImGui_Panels, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("ImGui Thread Wait"), STAT_ImGui_ThreadWait, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Deferred Draw Replay"), STAT_ImGui_DeferredReplay, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Render"), STAT_ImGui_Render, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Update Platform Windows"), STAT_ImGui_UpdatePlatformWindows, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Draw Data Handoff"), STAT_ImGui_DrawDataHandoff, STATGROUP_ImGui);
+
+UE_TRACE_CHANNEL_DEFINE(ImGuiChannel);
+
+// Scope on ImGuiChannel while Insights records it, cycle stat for stat ImGui otherwise. Only one of them is emitted so
+// a scope never shows up twice in a trace recorded with named stat events
+#if CPUPROFILERTRACE_ENABLED
+#define IMGUI_SCOPE_CYCLE_COUNTER(Stat, Name) \
+	CONDITIONAL_SCOPE_CYCLE_COUNTER(Stat, !UE_TRACE_CHANNELEXPR_IS_ENABLED(CpuChannel | ImGuiChannel)); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(Name, ImGuiChannel)
+#else
+#define IMGUI_SCOPE_CYCLE_COUNTER(Stat, Name) SCOPE_CYCLE_COUNTER(Stat)
+#endif
+
+static int32 GImGuiSimdVertexConversion = 1;
+static FAutoConsoleVariableRef CVarImGuiSimdVertexConversion(
+	TEXT("ImGui.Paint.SimdVertexConversion"),
+	GImGuiSimdVertexConversion,
+	TEXT("0: convert ImGui vertices one at a time, 1: convert ImGui vertices 4 at a time with vector instructions"),
+	ECVF_Default
+);
+
+static int32 GImGuiCoalesceDrawCommands = 1;
+static FAutoConsoleVariableRef CVarImGuiCoalesceDrawCommands(
+	TEXT("ImGui.DrawData.CoalesceDrawCommands"),
+	GImGuiCoalesceDrawCommands,
+	TEXT("0: submit every ImDrawCmd as is, 1: merge adjacent draw commands sharing texture and clip rect and drop empty or off-screen ones"),
+	ECVF_Default
+);
+
+static int32 GImGuiReuseUnchangedGeometry = 1;
+static uint32 GImGuiGeometryCacheGeneration = 0; // Bumped on every toggle, cached geometry from another generation is rebuilt
+static FAutoConsoleVariableRef CVarImGuiReuseUnchangedGeometry(
+	TEXT("ImGui.Paint.ReuseUnchangedGeometry"),
+	GImGuiReuseUnchangedGeometry,
+	TEXT("0: convert every draw list on every paint, 1: reuse the Slate geometry of draw lists whose content hash didn't change"),
+	FConsoleVariableDelegate::CreateLambda([](IConsoleVariable*) { ++GImGuiGeometryCacheGeneration; }),
+	ECVF_Default
+);
+
+static int32 GImGuiRetainedCanvas = 0;
+static FAutoConsoleVariableRef CVarImGuiRetainedCanvas(
+	TEXT("ImGui.Canvas.Retained"),
+	GImGuiRetainedCanvas,
+	TEXT("0: canvases are painted every frame, 1: new canvases are wrapped in an invalidation panel that replays their last painted elements until they receive new draw data"),
+	ECVF_Default
+);
+
+static int32 GImGuiRenderThreadDraw = 0;
+static FAutoConsoleVariableRef CVarImGuiRenderThreadDraw(
+	TEXT("ImGui.Canvas.RenderThreadDraw"),
+	GImGuiRenderThreadDraw,
+	TEXT("0: canvases convert draw data to Slate vertices while painting, 1: canvases hand a draw data snapshot to a custom Slate element drawn on the rendering thread"),
+	ECVF_Default
+);
+
+static int32 GImGuiParallelConversion = 0;
+static FAutoConsoleVariableRef CVarImGuiParallelConversion(
+	TEXT("ImGui.Canvas.ParallelConversion"),
+	GImGuiParallelConversion,
+	TEXT("0: canvases convert their draw data while painting, 1: draw lists of every viewport are converted in parallel before Slate paints (requires ImGui.Paint.ReuseUnchangedGeometry)"),
+	ECVF_Default
+);
+
+static int32 GImGuiLazyFrames = 0;
+static FAutoConsoleVariableRef CVarImGuiLazyFrames(
+	TEXT("ImGui.Frame.Lazy"),
+	GImGuiLazyFrames,
+	TEXT("0: render every ImGui frame, 1: skip rendering frames without input, animation or redraw request, canvases keep painting the last draw data"),
+	ECVF_Default
+);
+
+static float GImGuiLazyMinRefreshRate = 10.0f;
+static FAutoConsoleVariableRef CVarImGuiLazyMinRefreshRate(
+	TEXT("ImGui.Frame.LazyMinRefreshRate"),
+	GImGuiLazyMinRefreshRate,
+	TEXT("Minimum number of ImGui frames rendered per second when ImGui.Frame.Lazy is enabled, so panels displaying live values still refresh. 0: no periodic refresh"),
+	ECVF_Default
+);
+
+static float GImGuiMaxUpdateRate = 0.0f;
+static FAutoConsoleVariableRef CVarImGuiMaxUpdateRate(
+	TEXT("ImGui.Frame.MaxUpdateRate"),
+	GImGuiMaxUpdateRate,
+	TEXT("Maximum number of ImGui frames rendered per second regardless of the engine tick rate, input keeps being processed every tick. 0: unlimited"),
+	ECVF_Default
+);
+
+static int32 GImGuiThreadEnable = 0;
+static FAutoConsoleVariableRef CVarImGuiThreadEnable(
+	TEXT("ImGui.Thread.Enable"),
+	GImGuiThreadEnable,
+	TEXT("0: registered panels are drawn on the game thread in the default context, 1: registered panels are built on a dedicated ImGui thread and shown in their own window"),
+	ECVF_Default
+);
+
+static int32 GImGuiPerGameViewportContexts = 0;
+static FAutoConsoleVariableRef CVarImGuiPerGameViewportContexts(
+	TEXT("ImGui.Context.PerGameViewport"),
+	GImGuiPerGameViewportContexts,
+	TEXT("0: a single ImGui context drawn in the primary game viewport, 1: every game viewport (e.g. each PIE client) gets its own ImGui context, all sharing one font atlas"),
+	ECVF_Default
+);
+
+static int32 GImGuiProfilerEnable = 0;
+static FAutoConsoleVariableRef CVarImGuiProfilerEnable(
+	TEXT("ImGui.Profiler.Enable"),
+	GImGuiProfilerEnable,
+	TEXT("0: no per window cost attribution, 1: collect the vertices, indices, draw commands and build time of every ImGui window and show them in the ImGui Profiler window"),
+	ECVF_Default
+);
+
+static int32 GImGuiCoalesceMouseMoves = 1;
+static FAutoConsoleVariableRef CVarImGuiCoalesceMouseMoves(
+	TEXT("ImGui.Input.CoalesceMouseMoves"),
+	GImGuiCoalesceMouseMoves,
+	TEXT("0: forward every Slate mouse move to ImGui, 1: canvases only forward the last mouse position before another input event or the next ImGui frame"),
+	ECVF_Default
+);
+
+static int32 GImGuiWindowPoolSize = 8;
+static FAutoConsoleVariableRef CVarImGuiWindowPoolSize(
+	TEXT("ImGui.Viewport.WindowPoolSize"),
+	GImGuiWindowPoolSize,
+	TEXT("Number of hidden platform windows kept around to be reused by the next ImGui viewports (tooltips, popups, combo boxes) instead of creating native windows. 0: every viewport creates and destroys its window"),
+	ECVF_Default
+);
+
+static int32 GImGuiSkipHiddenViewports = 1;
+static FAutoConsoleVariableRef CVarImGuiSkipHiddenViewports(
+	TEXT("ImGui.Viewport.SkipHidden"),
+	GImGuiSkipHiddenViewports,
+	TEXT("0: draw data is handed to every viewport canvas, 1: minimized or hidden viewports (including the ones whose parent window is minimized) keep their last draw data instead of copying and converting the new one"),
+	ECVF_Default
+);
+
+static int32 GImGuiSkipHiddenViewportWindows = 0;
+static FAutoConsoleVariableRef CVarImGuiSkipHiddenViewportWindows(
+	TEXT("ImGui.Viewport.SkipHiddenWindows"),
+	GImGuiSkipHiddenViewportWindows,
+	TEXT("0: ImGui windows are built whether their viewport is visible or not, 1: ImGui windows docked or merged in a minimized or hidden platform window are hidden for the frame. Their Begin returns false so the code building their content is skipped, game code relying on it running every frame is skipped too. The window owning the platform window (a floating window or the dock node hosting the docked ones) is still built so the platform window stays open"),
+	ECVF_Default
+);
+
+// Frames still rendered after the last activity, ImGui layout (auto-resizing windows, docking) can take a couple of frames to settle
+static constexpr int32 LazyFrameSettleCount = 2;
 
 namespace ImGuiInterop
 {
 	
-// Copy of ImDrawList for safekeeping 
+// Copy of ImDrawList for safekeeping
+// @NOTE: The buffers are owned by the canvas and only grow, copying a draw list is one memcpy per buffer without any
+// allocation once they reached their working size. ImGui keeps its own draw data intact for GetDrawData, the Metrics
+// window or any later reader.
 struct FImGuiDrawList
 {
-	TArray<ImDrawCmd> CmdBuffer;
-	TArray<ImDrawIdx> IdxBuffer;
-	TArray<ImDrawVert> VtxBuffer;
+	ImVector<ImDrawCmd> CmdBuffer;
+	ImVector<ImDrawIdx> IdxBuffer;
+	ImVector<ImDrawVert> VtxBuffer;
 	ImDrawListFlags Flags;
+	uint64 Hash = 0; // Content hash of the buffers, identical draw lists produce identical Slate geometry
 
-	void Set(ImDrawList* DrawList);
+	void Set(const ImDrawList* DrawList);
+	void CoalesceCommands(const ImVec4& DisplayRect);
+	void ComputeHash();
+	uint32 GetDataSize() const;
 };
 
-void FImGuiDrawList::Set(ImDrawList* DrawList)
+// @NOTE: ImVector::operator= frees the destination before copying, resize keeps the capacity
+template <typename ElementType>
+static void CopyBuffer(ImVector<ElementType>& Dest, const ImVector<ElementType>& Source)
 {
-	for (int i = 0; i < DrawList->CmdBuffer.size(); ++i)
+	Dest.resize(Source.Size);
+	if (Source.Size > 0)
 	{
-		CmdBuffer.Add(DrawList->CmdBuffer[i]);
+		FMemory::Memcpy(Dest.Data, Source.Data, Source.size_in_bytes());
 	}
+}
+
+void FImGuiDrawList::Set(const ImDrawList* DrawList)
+{
+	CopyBuffer(CmdBuffer, DrawList->CmdBuffer);
+	CopyBuffer(IdxBuffer, DrawList->IdxBuffer);
+	CopyBuffer(VtxBuffer, DrawList->VtxBuffer);
 
-	for (int i = 0; i < DrawList->IdxBuffer.size(); ++i)
+	Flags = DrawList->Flags;
+}
+
+// Merges consecutive commands that would end up as identical Slate elements, and removes the ones that can't produce
+// any pixel. Commands with a user callback are kept as is and never merged.
+void FImGuiDrawList::CoalesceCommands(const ImVec4& DisplayRect)
+{
+	int OutIndex = 0;
+	for (int CmdIndex = 0; CmdIndex < CmdBuffer.Size; ++CmdIndex)
 	{
-		IdxBuffer.Add(DrawList->IdxBuffer[i]);
+		const ImDrawCmd& DrawCmd = CmdBuffer[CmdIndex];
+		if (!DrawCmd.UserCallback)
+		{
+			const ImVec4& ClipRect = DrawCmd.ClipRect;
+			const bool bEmptyClipRect = ClipRect.z <= ClipRect.x || ClipRect.w <= ClipRect.y;
+			const bool bCulled = ClipRect.z <= DisplayRect.x || ClipRect.x >= DisplayRect.z
+				|| ClipRect.w <= DisplayRect.y || ClipRect.y >= DisplayRect.w;
+			if (DrawCmd.ElemCount == 0 || bEmptyClipRect || bCulled)
+			{
+				continue;
+			}
+
+			if (OutIndex > 0)
+			{
+				ImDrawCmd& PrevCmd = CmdBuffer[OutIndex - 1];
+				if (!PrevCmd.UserCallback
+					&& PrevCmd.TextureId == DrawCmd.TextureId
+					&& PrevCmd.VtxOffset == DrawCmd.VtxOffset
+					&& PrevCmd.IdxOffset + PrevCmd.ElemCount == DrawCmd.IdxOffset
+					&& FMemory::Memcmp(&PrevCmd.ClipRect, &ClipRect, sizeof(ImVec4)) == 0)
+				{
+					PrevCmd.ElemCount += DrawCmd.ElemCount;
+					continue;
+				}
+			}
+		}
+
+		CmdBuffer[OutIndex++] = DrawCmd;
 	}
+	CmdBuffer.resize(OutIndex);
+}
 
-	for (int i = 0; i < DrawList->VtxBuffer.size(); ++i)
+void FImGuiDrawList::ComputeHash()
+{
+	FXxHash64Builder Builder;
+	Builder.Update(VtxBuffer.Data, VtxBuffer.size_in_bytes());
+	Builder.Update(IdxBuffer.Data, IdxBuffer.size_in_bytes());
+	for (const ImDrawCmd& DrawCmd : CmdBuffer)
 	{
-		VtxBuffer.Add(DrawList->VtxBuffer[i]);
+		// @NOTE: Hash fields one by one, ImDrawCmd has padding
+		Builder.Update(&DrawCmd.ClipRect, sizeof(DrawCmd.ClipRect));
+		Builder.Update(&DrawCmd.TextureId, sizeof(DrawCmd.TextureId));
+		Builder.Update(&DrawCmd.VtxOffset, sizeof(DrawCmd.VtxOffset));
+		Builder.Update(&DrawCmd.IdxOffset, sizeof(DrawCmd.IdxOffset));
+		Builder.Update(&DrawCmd.ElemCount, sizeof(DrawCmd.ElemCount));
 	}
+	Hash = Builder.Finalize().Hash;
+}
 
-	Flags = DrawList->Flags;
+uint32 FImGuiDrawList::GetDataSize() const
+{
+	return CmdBuffer.size_in_bytes() + IdxBuffer.size_in_bytes() + VtxBuffer.size_in_bytes();
 }
 
+// Copy of ImDrawData the canvas paints from, see FImGuiDrawList
 struct FImGuiDrawData
 {
+	// Entries past CmdListsCount keep their buffers around, they're released once unused for that many Set
+	static constexpr int32 ShrinkPeriod = 300;
+
 	int CmdListsCount = 0; // Number of ImDrawList* to render
 	int TotalIdxCount; // For convenience, sum of all ImDrawList's IdxBuffer.Size
 	int TotalVtxCount; // For convenience, sum of all ImDrawList's VtxBuffer.Size
-	TArray<FImGuiDrawList> CmdLists; // Array of ImDrawList to render.
+	TArray<FImGuiDrawList> CmdLists; // Array of ImDrawList to render
+	int32 CmdListsHighWaterMark = 0;
+	int32 SetsSinceShrink = 0;
+	uint64 Hash = 0; // Combined content hash of the draw lists and display position
 	ImVec2 DisplayPos;
 	// Top-left position of the viewport to render (== top-left of the orthogonal projection matrix to use) (== GetMainViewport()->Pos for the main viewport, == (0.0) in most single-viewport applications)
 	ImVec2 DisplaySize;
@@ -65,6 +355,7 @@ struct FImGuiDrawData
 
 void FImGuiDrawData::Set(ImDrawData* DrawData)
 {
+	FImGuiPerfScope PerfScope(EImGuiPerfTimer::DrawDataSet);
 	check(DrawData->Valid);
 
 	CmdListsCount = DrawData->CmdListsCount;
@@ -75,12 +366,621 @@ void FImGuiDrawData::Set(ImDrawData* DrawData)
 	FramebufferScale = DrawData->FramebufferScale;
 	OwnerViewport = DrawData->OwnerViewport;
 
-	CmdLists.Empty();
-	for (int i = 0; i < DrawData->CmdListsCount; ++i)
+	CmdListsHighWaterMark = FMath::Max(CmdListsHighWaterMark, CmdListsCount);
+	if (++SetsSinceShrink >= ShrinkPeriod)
+	{
+		if (CmdLists.Num() > CmdListsHighWaterMark)
+		{
+			CmdLists.SetNum(CmdListsHighWaterMark);
+		}
+		CmdListsHighWaterMark = CmdListsCount;
+		SetsSinceShrink = 0;
+	}
+	if (CmdLists.Num() < CmdListsCount)
+	{
+		CmdLists.SetNum(CmdListsCount);
+	}
+
+	const ImVec4 DisplayRect = {DisplayPos.x, DisplayPos.y, DisplayPos.x + DisplaySize.x, DisplayPos.y + DisplaySize.y};
+
+	FXxHash64Builder HashBuilder;
+	HashBuilder.Update(&DisplayPos, sizeof(DisplayPos));
+	HashBuilder.Update(&CmdListsCount, sizeof(CmdListsCount));
+
+	uint32 BytesHandedOff = 0;
+	for (int i = 0; i < CmdListsCount; ++i)
 	{
-		FImGuiDrawList& Cmd = CmdLists.Add_GetRef({});
+		FImGuiDrawList& Cmd = CmdLists[i];
+		const int PreviousVtxCount = Cmd.VtxBuffer.Size;
+		const int PreviousCmdCount = Cmd.CmdBuffer.Size;
 		Cmd.Set(DrawData->CmdLists[i]);
+		BytesHandedOff += Cmd.GetDataSize();
+
+		INC_DWORD_STAT_BY(STAT_ImGui_DrawCmdsBeforeCoalescing, Cmd.CmdBuffer.Size);
+		if (GImGuiCoalesceDrawCommands)
+		{
+			Cmd.CoalesceCommands(DisplayRect);
+		}
+		INC_DWORD_STAT_BY(STAT_ImGui_DrawCmdsAfterCoalescing, Cmd.CmdBuffer.Size);
+
+		// @NOTE: A draw list whose sizes changed can't match its previous content, give it a new hash without reading
+		// its buffers. Only the ones that may be unchanged are hashed.
+		if (Cmd.VtxBuffer.Size == PreviousVtxCount && Cmd.CmdBuffer.Size == PreviousCmdCount)
+		{
+			Cmd.ComputeHash();
+			INC_DWORD_STAT(STAT_ImGui_DrawListsHashed);
+		}
+		else
+		{
+			++Cmd.Hash;
+		}
+		HashBuilder.Update(&Cmd.Hash, sizeof(Cmd.Hash));
+	}
+	Hash = HashBuilder.Finalize().Hash;
+	INC_DWORD_STAT_BY(STAT_ImGui_DrawDataBytes, BytesHandedOff);
+	INC_DWORD_STAT_BY(STAT_ImGui_DrawLists, CmdListsCount);
+	INC_DWORD_STAT_BY(STAT_ImGui_Vertices, TotalVtxCount);
+	INC_DWORD_STAT_BY(STAT_ImGui_Indices, TotalIdxCount);
+}
+
+// Scratch buffer owned by a canvas and reused across paints. It only grows while painting, and gives memory back
+// at most once every ShrinkPeriod paints when the peak usage over that period stayed well below its capacity.
+// @NOTE: This only covers the canvas side, Slate still copies the arena content into every draw element it makes,
+// see STAT_ImGui_SlateElementAllocations
+template <typename ElementType>
+struct TImGuiFrameArena
+{
+	static constexpr int32 ShrinkPeriod = 300;
+	static constexpr int32 ShrinkSlack = 1024;
+
+	~TImGuiFrameArena();
+
+	// Returns the buffer resized to Num elements, content is left uninitialized
+	TArray<ElementType>& Get(int32 Num);
+	const TArray<ElementType>& GetBuffer() const { return Buffer; }
+	void EndFrame();
+
+private:
+	void TrackAllocation(SIZE_T PreviousSize);
+
+	TArray<ElementType> Buffer;
+	int32 HighWaterMark = 0;
+	int32 FramesSinceShrink = 0;
+};
+
+template <typename ElementType>
+TImGuiFrameArena<ElementType>::~TImGuiFrameArena()
+{
+	DEC_MEMORY_STAT_BY(STAT_ImGui_PaintArenaMemory, Buffer.GetAllocatedSize());
+}
+
+template <typename ElementType>
+TArray<ElementType>& TImGuiFrameArena<ElementType>::Get(int32 Num)
+{
+	HighWaterMark = FMath::Max(HighWaterMark, Num);
+
+	const int32 PreviousMax = Buffer.Max();
+	const SIZE_T PreviousSize = Buffer.GetAllocatedSize();
+	Buffer.SetNumUninitialized(Num, false);
+	if (Buffer.Max() != PreviousMax)
+	{
+		TrackAllocation(PreviousSize);
+	}
+	return Buffer;
+}
+
+template <typename ElementType>
+void TImGuiFrameArena<ElementType>::EndFrame()
+{
+	HighWaterMark = FMath::Max(HighWaterMark, Buffer.Num());
+	if (++FramesSinceShrink < ShrinkPeriod)
+	{
+		return;
+	}
+
+	if (Buffer.Max() > HighWaterMark * 2 + ShrinkSlack)
+	{
+		const SIZE_T PreviousSize = Buffer.GetAllocatedSize();
+		Buffer.SetNumUninitialized(HighWaterMark, false);
+		Buffer.Shrink();
+		TrackAllocation(PreviousSize);
+	}
+	HighWaterMark = 0;
+	FramesSinceShrink = 0;
+}
+
+template <typename ElementType>
+void TImGuiFrameArena<ElementType>::TrackAllocation(SIZE_T PreviousSize)
+{
+	INC_DWORD_STAT(STAT_ImGui_PaintArenaAllocations);
+	DEC_MEMORY_STAT_BY(STAT_ImGui_PaintArenaMemory, PreviousSize);
+	INC_MEMORY_STAT_BY(STAT_ImGui_PaintArenaMemory, Buffer.GetAllocatedSize());
+}
+
+// ImGui packs colors as RGBA8 and FColor as BGRA8, going from one to the other is a swap of the R and B bytes
+static FORCEINLINE FColor ImGuiToSlateColor(ImU32 Color)
+{
+	return FColor((Color & 0xFF00FF00) | ((Color & 0x00FF0000) >> 16) | ((Color & 0x000000FF) << 16));
+}
+
+static void ConvertVerticesScalar(const ImDrawVert* Src, FSlateVertex* Dst, int32 Count, const FSlateRenderTransform& Transform)
+{
+	for (int32 VtxIndex = 0; VtxIndex < Count; ++VtxIndex)
+	{
+		const ImDrawVert& Vtx = Src[VtxIndex];
+		Dst[VtxIndex] = FSlateVertex::Make<ESlateVertexRounding::Enabled>(
+			Transform,
+			FVector2f{Vtx.pos.x, Vtx.pos.y},
+			FVector2f{Vtx.uv.x, Vtx.uv.y},
+			FVector2f{1.0f, 1.0f},
+			ImGuiToSlateColor(Vtx.col));
+	}
+}
+
+// The vector path writes whole FSlateVertex as 11 dwords per vertex and reads ImDrawVert as 5 dwords per vertex
+static_assert(sizeof(ImDrawVert) == 20 && STRUCT_OFFSET(ImDrawVert, uv) == 8 && STRUCT_OFFSET(ImDrawVert, col) == 16, "Unexpected ImDrawVert layout");
+static_assert(sizeof(FSlateVertex) == 44, "Unexpected FSlateVertex layout");
+static_assert(STRUCT_OFFSET(FSlateVertex, TexCoords) == 0 && STRUCT_OFFSET(FSlateVertex, MaterialTexCoords) == 16
+	&& STRUCT_OFFSET(FSlateVertex, Position) == 24 && STRUCT_OFFSET(FSlateVertex, Color) == 32
+	&& STRUCT_OFFSET(FSlateVertex, SecondaryColor) == 36 && STRUCT_OFFSET(FSlateVertex, PixelSize) == 40, "Unexpected FSlateVertex layout");
+
+// Converts ImGui vertices to Slate vertices, output is bit identical to ConvertVerticesScalar with a translation only
+// render transform. Vertices are processed 4 at a time: 5 loads, shuffles to transpose them into position, UV and
+// color registers, and 11 stores of whole Slate vertices. The remainder goes through the scalar path.
+static void ConvertVertices(const ImDrawVert* Src, FSlateVertex* Dst, int32 Count, const FVector2f& Translation)
+{
+	int32 VtxIndex = 0;
+	if (GImGuiSimdVertexConversion && Count >= 4)
+	{
+		// @NOTE: Fields that don't depend on the ImGui vertex (TexCoords[2..3], SecondaryColor, PixelSize) are taken from
+		// a vertex made by the scalar path, so they match whatever FSlateVertex::Make sets them to
+		FSlateVertex Prototype;
+		const ImDrawVert ZeroVtx = {};
+		ConvertVerticesScalar(&ZeroVtx, &Prototype, 1, FSlateRenderTransform());
+		const float* PrototypeDwords = reinterpret_cast<const float*>(&Prototype);
+		const VectorRegister4Float Constants = MakeVectorRegisterFloat(PrototypeDwords[2], PrototypeDwords[3], PrototypeDwords[9], PrototypeDwords[10]);
+
+		const VectorRegister4Float VecTranslation = MakeVectorRegisterFloat(Translation.X, Translation.Y, Translation.X, Translation.Y);
+		constexpr int32 AlphaGreen = static_cast<int32>(0xFF00FF00);
+		const VectorRegister4Int AlphaGreenMask = MakeVectorRegisterInt(AlphaGreen, AlphaGreen, AlphaGreen, AlphaGreen);
+		const VectorRegister4Int RedMask = MakeVectorRegisterInt(0x000000FF, 0x000000FF, 0x000000FF, 0x000000FF);
+		const VectorRegister4Int BlueMask = MakeVectorRegisterInt(0x00FF0000, 0x00FF0000, 0x00FF0000, 0x00FF0000);
+
+		for (; VtxIndex + 4 <= Count; VtxIndex += 4)
+		{
+			// In0 = [p0x p0y u0 v0] In1 = [c0 p1x p1y u1] In2 = [v1 c1 p2x p2y] In3 = [u2 v2 c2 p3x] In4 = [p3y u3 v3 c3]
+			const float* In = reinterpret_cast<const float*>(Src + VtxIndex);
+			const VectorRegister4Float In0 = VectorLoad(In);
+			const VectorRegister4Float In1 = VectorLoad(In + 4);
+			const VectorRegister4Float In2 = VectorLoad(In + 8);
+			const VectorRegister4Float In3 = VectorLoad(In + 12);
+			const VectorRegister4Float In4 = VectorLoad(In + 16);
+
+			VectorRegister4Float Pos01 = VectorShuffle(In0, In1, 0, 1, 1, 2);
+			VectorRegister4Float Pos23 = VectorShuffle(In2, VectorShuffle(In3, In4, 3, 3, 0, 0), 2, 3, 0, 2);
+			const VectorRegister4Float UV01 = VectorShuffle(In0, VectorShuffle(In1, In2, 3, 3, 0, 0), 2, 3, 0, 2);
+			const VectorRegister4Float UV23 = VectorShuffle(In3, In4, 0, 1, 1, 2);
+			const VectorRegister4Float PackedColors = VectorShuffle(VectorShuffle(In1, In2, 0, 0, 1, 1), VectorShuffle(In3, In4, 2, 2, 3, 3), 0, 2, 0, 2);
+
+			// Same as FMath::RoundToFloat, floor(x + 0.5)
+			Pos01 = VectorFloor(VectorAdd(VectorAdd(Pos01, VecTranslation), GlobalVectorConstants::FloatOneHalf));
+			Pos23 = VectorFloor(VectorAdd(VectorAdd(Pos23, VecTranslation), GlobalVectorConstants::FloatOneHalf));
+
+			// RGBA8 to BGRA8, see ImGuiToSlateColor
+			const VectorRegister4Int Packed = VectorCastFloatToInt(PackedColors);
+			const VectorRegister4Float Colors = VectorCastIntToFloat(VectorIntOr(
+				VectorIntAnd(Packed, AlphaGreenMask),
+				VectorIntOr(
+					VectorShiftRightImmLogical(VectorIntAnd(Packed, BlueMask), 16),
+					VectorShiftLeftImm(VectorIntAnd(Packed, RedMask), 16))));
+
+			// Slate vertex i is [u v K2 K3 | u v | x y | c | SC | PS], Constants = [K2 K3 SC PS]
+			float* Out = reinterpret_cast<float*>(Dst + VtxIndex);
+			VectorStore(VectorShuffle(UV01, Constants, 0, 1, 0, 1), Out);
+			VectorStore(VectorShuffle(UV01, Pos01, 0, 1, 0, 1), Out + 4);
+			VectorStore(VectorShuffle(VectorShuffle(Colors, Constants, 0, 0, 2, 2), VectorShuffle(Constants, UV01, 3, 3, 2, 2), 0, 2, 0, 2), Out + 8);
+			VectorStore(VectorShuffle(VectorShuffle(UV01, Constants, 3, 3, 0, 0), VectorShuffle(Constants, UV01, 1, 1, 2, 2), 0, 2, 0, 2), Out + 12);
+			VectorStore(VectorShuffle(VectorShuffle(UV01, Pos01, 3, 3, 2, 2), VectorShuffle(Pos01, Colors, 3, 3, 1, 1), 0, 2, 0, 2), Out + 16);
+			VectorStore(VectorShuffle(Constants, UV23, 2, 3, 0, 1), Out + 20);
+			VectorStore(VectorShuffle(Constants, UV23, 0, 1, 0, 1), Out + 24);
+			VectorStore(VectorShuffle(Pos23, VectorShuffle(Colors, Constants, 2, 2, 2, 2), 0, 1, 0, 2), Out + 28);
+			VectorStore(VectorShuffle(VectorShuffle(Constants, UV23, 3, 3, 2, 2), VectorShuffle(UV23, Constants, 3, 3, 0, 0), 0, 2, 0, 2), Out + 32);
+			VectorStore(VectorShuffle(VectorShuffle(Constants, UV23, 1, 1, 2, 2), VectorShuffle(UV23, Pos23, 3, 3, 2, 2), 0, 2, 0, 2), Out + 36);
+			VectorStore(VectorShuffle(VectorShuffle(Pos23, Colors, 3, 3, 3, 3), Constants, 0, 2, 2, 3), Out + 40);
+		}
+	}
+
+	ConvertVerticesScalar(Src + VtxIndex, Dst + VtxIndex, Count - VtxIndex, FSlateRenderTransform(Translation));
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FImGuiVertexConversionTest, "UnrealImGuiDocker.VertexConversion",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Checks the vector conversion is bit identical to the scalar one, and logs the time both take per vertex
+bool FImGuiVertexConversionTest::RunTest(const FString& Parameters)
+{
+	TGuardValue<int32> SimdGuard(GImGuiSimdVertexConversion, 1);
+
+	// Coordinates on and around rounding boundaries, negative ones and large ones, colors with every byte set
+	FRandomStream Random(0x1A6E);
+	TArray<ImDrawVert> Source;
+	Source.SetNumUninitialized(64 * 1024 + 3);
+	for (ImDrawVert& Vtx : Source)
+	{
+		const float Scale = Random.RandRange(0, 3) == 0 ? 0.5f : 1.0f / 64.0f;
+		Vtx.pos = ImVec2(Random.RandRange(-8192, 8192) * Scale, Random.RandRange(-8192, 8192) * Scale);
+		Vtx.uv = ImVec2(Random.GetFraction(), Random.GetFraction());
+		Vtx.col = static_cast<ImU32>(Random.GetUnsignedInt());
+	}
+
+	const FVector2f Translations[] = {{0.0f, 0.0f}, {0.5f, -0.5f}, {123.25f, 77.75f}, {-1920.0f, 1080.0f}};
+	TArray<FSlateVertex> Expected;
+	TArray<FSlateVertex> Actual;
+	Expected.SetNumUninitialized(Source.Num());
+	Actual.SetNumUninitialized(Source.Num());
+	for (const FVector2f& Translation : Translations)
+	{
+		// Every count up to 9 covers the remainder paths, then the whole buffer
+		for (const int32 Count : {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, Source.Num()})
+		{
+			FMemory::Memset(Expected.GetData(), 0xCD, Expected.Num() * sizeof(FSlateVertex));
+			FMemory::Memset(Actual.GetData(), 0xCD, Actual.Num() * sizeof(FSlateVertex));
+			ImGuiInterop::ConvertVerticesScalar(Source.GetData(), Expected.GetData(), Count, FSlateRenderTransform(Translation));
+			ImGuiInterop::ConvertVertices(Source.GetData(), Actual.GetData(), Count, Translation);
+
+			for (int32 VtxIndex = 0; VtxIndex < Expected.Num(); ++VtxIndex)
+			{
+				if (FMemory::Memcmp(&Expected[VtxIndex], &Actual[VtxIndex], sizeof(FSlateVertex)) != 0)
+				{
+					AddError(FString::Printf(TEXT("Vertex %d of %d differs with translation %s"), VtxIndex, Count, *Translation.ToString()));
+					return false;
+				}
+			}
+		}
+	}
+
+	constexpr int32 Iterations = 100;
+	const FVector2f Translation = {123.25f, 77.75f};
+	uint64 ScalarCycles = MAX_uint64;
+	uint64 VectorCycles = MAX_uint64;
+	for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+	{
+		uint64 StartCycles = FPlatformTime::Cycles64();
+		ImGuiInterop::ConvertVerticesScalar(Source.GetData(), Expected.GetData(), Source.Num(), FSlateRenderTransform(Translation));
+		ScalarCycles = FMath::Min(ScalarCycles, FPlatformTime::Cycles64() - StartCycles);
+
+		StartCycles = FPlatformTime::Cycles64();
+		ImGuiInterop::ConvertVertices(Source.GetData(), Actual.GetData(), Source.Num(), Translation);
+		VectorCycles = FMath::Min(VectorCycles, FPlatformTime::Cycles64() - StartCycles);
+	}
+	const double ScalarNs = FPlatformTime::ToSeconds64(ScalarCycles) * 1e9 / Source.Num();
+	const double VectorNs = FPlatformTime::ToSeconds64(VectorCycles) * 1e9 / Source.Num();
+	AddInfo(FString::Printf(TEXT("Best of %d over %d vertices: scalar %.2f ns/vertex, vector %.2f ns/vertex (x%.2f)"),
+		Iterations, Source.Num(), ScalarNs, VectorNs, VectorNs > 0.0 ? ScalarNs / VectorNs : 0.0));
+	return true;
+}
+
+#endif
+
+// Clip rect of a draw command in window space restricted to the culling rect, nothing of the command can be visible
+// when it's empty
+static FSlateRect GetVisibleClipRect(const ImVec4& ClipRect, const FVector2f& Translation, const FSlateRect& CullingRect)
+{
+	const FSlateRect WindowClipRect = FSlateRect(
+		ClipRect.x + Translation.X,
+		ClipRect.y + Translation.Y,
+		ClipRect.z + Translation.X,
+		ClipRect.w + Translation.Y);
+	return WindowClipRect.IntersectionWith(CullingRect);
+}
+
+static bool IsRectEmpty(const FSlateRect& Rect)
+{
+	return Rect.Right <= Rect.Left || Rect.Bottom <= Rect.Top;
+}
+
+static bool IsAnyCommandVisible(const FImGuiDrawList& DrawList, const FVector2f& Translation, const FSlateRect& CullingRect)
+{
+	for (const ImDrawCmd& DrawCmd : DrawList.CmdBuffer)
+	{
+		if (DrawCmd.ElemCount > 0 && !IsRectEmpty(GetVisibleClipRect(DrawCmd.ClipRect, Translation, CullingRect)))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Slate geometry built from one draw command, kept around as long as its draw list content doesn't change
+struct FImGuiCachedDrawCmd
+{
+	TImGuiFrameArena<FSlateVertex> Vertices;
+	TImGuiFrameArena<SlateIndex> Indices;
+	ImTextureID TextureId;
+	ImVec4 ClipRect;
+};
+
+struct FImGuiCachedDrawList
+{
+	// Entries past NumCmds keep their arenas around, they're released once unused for that many paints
+	static constexpr int32 TrimPeriod = 300;
+
+	uint64 Hash = 0;
+	FVector2f Translation = FVector2f::ZeroVector;
+	uint32 Generation = 0; // GImGuiGeometryCacheGeneration when built
+	bool bValid = false;
+	int32 NumCmds = 0;
+	int32 CmdsHighWaterMark = 0;
+	int32 PaintsSinceTrim = 0;
+	TImGuiFrameArena<FSlateVertex> Vertices; // The whole vertex buffer of the draw list, converted once per build
+	TArray<FImGuiCachedDrawCmd> Cmds;
+
+	void Build(const FImGuiDrawList& DrawList, const FVector2f& InTranslation);
+	// Called once per paint of the owning canvas, whether the draw list got painted or not
+	void EndFrame();
+};
+
+void FImGuiCachedDrawList::Build(const FImGuiDrawList& DrawList, const FVector2f& InTranslation)
+{
+	Hash = DrawList.Hash;
+	Translation = InTranslation;
+	Generation = GImGuiGeometryCacheGeneration;
+	bValid = true;
+	NumCmds = 0;
+
+	if (Cmds.Num() < DrawList.CmdBuffer.Size)
+	{
+		Cmds.SetNum(DrawList.CmdBuffer.Size);
+	}
+
+	// @NOTE: Commands of a draw list split in channels (tables, columns, plot legends) reference overlapping vertex
+	// ranges, converting the buffer once keeps the conversion linear in the number of vertices
+	TArray<FSlateVertex>& ConvertedVertices = Vertices.Get(DrawList.VtxBuffer.Size);
+	ConvertVertices(DrawList.VtxBuffer.Data, ConvertedVertices.GetData(), DrawList.VtxBuffer.Size, Translation);
+
+	for (int CmdIndex = 0; CmdIndex < DrawList.CmdBuffer.Size; ++CmdIndex)
+	{
+		const ImDrawCmd& DrawCmd = DrawList.CmdBuffer[CmdIndex];
+		if (DrawCmd.ElemCount == 0)
+		{
+			continue;
+		}
+
+		FImGuiCachedDrawCmd& CachedCmd = Cmds[NumCmds++];
+		CachedCmd.TextureId = DrawCmd.TextureId;
+		CachedCmd.ClipRect = DrawCmd.ClipRect;
+
+		// Slate copies the vertices of every element, only hand it the ones this command references with indices
+		// rebased on the first one
+		const ImDrawIdx* CmdIndices = DrawList.IdxBuffer.Data + DrawCmd.IdxOffset;
+		ImDrawIdx MinIndex = CmdIndices[0];
+		ImDrawIdx MaxIndex = CmdIndices[0];
+		for (uint32 ElemIndex = 1; ElemIndex < DrawCmd.ElemCount; ++ElemIndex)
+		{
+			MinIndex = FMath::Min(MinIndex, CmdIndices[ElemIndex]);
+			MaxIndex = FMath::Max(MaxIndex, CmdIndices[ElemIndex]);
+		}
+
+		TArray<SlateIndex>& IndexBuffer = CachedCmd.Indices.Get(DrawCmd.ElemCount);
+		for (uint32 ElemIndex = 0; ElemIndex < DrawCmd.ElemCount; ++ElemIndex)
+		{
+			IndexBuffer[ElemIndex] = CmdIndices[ElemIndex] - MinIndex;
+		}
+
+		const int32 FirstVtx = DrawCmd.VtxOffset + MinIndex;
+		const int32 NumVtx = MaxIndex - MinIndex + 1;
+		check(FirstVtx + NumVtx <= DrawList.VtxBuffer.Size);
+		TArray<FSlateVertex>& VertexBuffer = CachedCmd.Vertices.Get(NumVtx);
+		FMemory::Memcpy(VertexBuffer.GetData(), ConvertedVertices.GetData() + FirstVtx, NumVtx * sizeof(FSlateVertex));
+	}
+}
+
+void FImGuiCachedDrawList::EndFrame()
+{
+	Vertices.EndFrame();
+	for (FImGuiCachedDrawCmd& CachedCmd : Cmds)
+	{
+		CachedCmd.Vertices.EndFrame();
+		CachedCmd.Indices.EndFrame();
+	}
+
+	CmdsHighWaterMark = FMath::Max(CmdsHighWaterMark, NumCmds);
+	if (++PaintsSinceTrim < TrimPeriod)
+	{
+		return;
+	}
+
+	if (Cmds.Num() > CmdsHighWaterMark)
+	{
+		Cmds.SetNum(CmdsHighWaterMark);
+	}
+	CmdsHighWaterMark = 0;
+	PaintsSinceTrim = 0;
+}
+
+static_assert(sizeof(ImDrawVert) == sizeof(FImGuiShaderVertex), "FImGuiShaderVertex must mirror ImDrawVert");
+static_assert(STRUCT_OFFSET(ImDrawVert, uv) == STRUCT_OFFSET(FImGuiShaderVertex, UV), "FImGuiShaderVertex must mirror ImDrawVert");
+static_assert(STRUCT_OFFSET(ImDrawVert, col) == STRUCT_OFFSET(FImGuiShaderVertex, Color), "FImGuiShaderVertex must mirror ImDrawVert");
+
+// Draw data handed to the rendering thread, never modified while a custom element references it
+struct FImGuiDrawDataSnapshot
+{
+	FImGuiDrawData DrawData;
+	TArray<TPair<ImTextureID, FTexture*>, TInlineAllocator<4>> Textures;
+
+	void ResolveTextures();
+	FRHITexture* FindTexture(ImTextureID TextureId) const;
+};
+
+// Game thread only, textures are looked up through their brush resource object
+void FImGuiDrawDataSnapshot::ResolveTextures()
+{
+	Textures.Reset();
+	for (int DrawListIdx = 0; DrawListIdx < DrawData.CmdListsCount; ++DrawListIdx)
+	{
+		for (const ImDrawCmd& DrawCmd : DrawData.CmdLists[DrawListIdx].CmdBuffer)
+		{
+			if (!DrawCmd.TextureId || Textures.ContainsByPredicate([&DrawCmd](const TPair<ImTextureID, FTexture*>& Texture) { return Texture.Key == DrawCmd.TextureId; }))
+			{
+				continue;
+			}
+
+			const FSlateBrush* Brush = (FSlateBrush*)DrawCmd.TextureId;
+			const UTexture* Texture = Cast<UTexture>(Brush->GetResourceObject());
+			Textures.Emplace(DrawCmd.TextureId, Texture ? Texture->GetResource() : nullptr);
+		}
+	}
+}
+
+FRHITexture* FImGuiDrawDataSnapshot::FindTexture(ImTextureID TextureId) const
+{
+	for (const TPair<ImTextureID, FTexture*>& Texture : Textures)
+	{
+		if (Texture.Key == TextureId && Texture.Value && Texture.Value->TextureRHI)
+		{
+			return Texture.Value->TextureRHI;
+		}
+	}
+	return GWhiteTexture->TextureRHI;
+}
+
+// Draws a snapshot straight into the window back buffer, ImGui vertices are uploaded as is so no conversion happens
+// on the game thread at all
+class FImGuiSlateElement : public ICustomSlateElement
+{
+public:
+	TSharedPtr<const FImGuiDrawDataSnapshot, ESPMode::ThreadSafe> Snapshot;
+	FVector2f Translation; // Draw data space to window space
+	FSlateRect CullingRect; // In window space
+
+	virtual void DrawRenderThread(FRHICommandListImmediate& RHICmdList, const void* RenderTarget) override;
+};
+
+void FImGuiSlateElement::DrawRenderThread(FRHICommandListImmediate& RHICmdList, const void* RenderTarget)
+{
+	IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_RenderThreadDraw, "ImGui Render Thread Draw");
+
+	if (!Snapshot)
+	{
+		return;
+	}
+
+	const FImGuiDrawData& DrawData = Snapshot->DrawData;
+	if (DrawData.TotalVtxCount <= 0 || DrawData.TotalIdxCount <= 0)
+	{
+		return;
+	}
+
+	FRHITexture* Target = static_cast<const FTexture2DRHIRef*>(RenderTarget)->GetReference();
+	const FIntPoint TargetSize = Target->GetSizeXY();
+
+	FRHIResourceCreateInfo VertexBufferInfo(TEXT("ImGuiVertexBuffer"));
+	FBufferRHIRef VertexBuffer = RHICmdList.CreateVertexBuffer(DrawData.TotalVtxCount * sizeof(ImDrawVert), BUF_Volatile, VertexBufferInfo);
+	FRHIResourceCreateInfo IndexBufferInfo(TEXT("ImGuiIndexBuffer"));
+	FBufferRHIRef IndexBuffer = RHICmdList.CreateIndexBuffer(sizeof(ImDrawIdx), DrawData.TotalIdxCount * sizeof(ImDrawIdx), BUF_Volatile, IndexBufferInfo);
+
+	ImDrawVert* VertexData = static_cast<ImDrawVert*>(RHICmdList.LockBuffer(VertexBuffer, 0, DrawData.TotalVtxCount * sizeof(ImDrawVert), RLM_WriteOnly));
+	ImDrawIdx* IndexData = static_cast<ImDrawIdx*>(RHICmdList.LockBuffer(IndexBuffer, 0, DrawData.TotalIdxCount * sizeof(ImDrawIdx), RLM_WriteOnly));
+	for (int DrawListIdx = 0; DrawListIdx < DrawData.CmdListsCount; ++DrawListIdx)
+	{
+		const FImGuiDrawList& DrawList = DrawData.CmdLists[DrawListIdx];
+		FMemory::Memcpy(VertexData, DrawList.VtxBuffer.Data, DrawList.VtxBuffer.size_in_bytes());
+		FMemory::Memcpy(IndexData, DrawList.IdxBuffer.Data, DrawList.IdxBuffer.size_in_bytes());
+		VertexData += DrawList.VtxBuffer.Size;
+		IndexData += DrawList.IdxBuffer.Size;
+	}
+	RHICmdList.UnlockBuffer(VertexBuffer);
+	RHICmdList.UnlockBuffer(IndexBuffer);
+
+	FRHIRenderPassInfo RenderPassInfo(Target, ERenderTargetActions::Load_Store);
+	RHICmdList.BeginRenderPass(RenderPassInfo, TEXT("ImGui"));
+	RHICmdList.SetViewport(0.0f, 0.0f, 0.0f, TargetSize.X, TargetSize.Y, 1.0f);
+
+	FGlobalShaderMap* ShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
+	TShaderMapRef<FImGuiVS> VertexShader(ShaderMap);
+	TShaderMapRef<FImGuiPS> PixelShader(ShaderMap);
+
+	FGraphicsPipelineStateInitializer GraphicsPSOInit;
+	RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+	GraphicsPSOInit.BlendState = TStaticBlendState<CW_RGBA, BO_Add, BF_SourceAlpha, BF_InverseSourceAlpha, BO_Add, BF_One, BF_InverseSourceAlpha>::GetRHI();
+	GraphicsPSOInit.RasterizerState = TStaticRasterizerState<FM_Solid, CM_None>::GetRHI();
+	GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+	GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GImGuiVertexDeclaration.VertexDeclarationRHI;
+	GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+	GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
+	GraphicsPSOInit.PrimitiveType = PT_TriangleList;
+	SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit, 0);
+
+	FImGuiVS::FParameters VSParameters;
+	VSParameters.ScaleAndOffset = FVector4f(
+		2.0f / TargetSize.X,
+		-2.0f / TargetSize.Y,
+		Translation.X * 2.0f / TargetSize.X - 1.0f,
+		1.0f - Translation.Y * 2.0f / TargetSize.Y);
+	SetShaderParameters(RHICmdList, VertexShader, VertexShader.GetVertexShader(), VSParameters);
+	RHICmdList.SetStreamSource(0, VertexBuffer, 0);
+
+	const FSlateRect TargetRect = CullingRect.IntersectionWith(FSlateRect(0.0f, 0.0f, TargetSize.X, TargetSize.Y));
+
+	int32 GlobalVtxOffset = 0;
+	int32 GlobalIdxOffset = 0;
+	for (int DrawListIdx = 0; DrawListIdx < DrawData.CmdListsCount; ++DrawListIdx)
+	{
+		const FImGuiDrawList& DrawList = DrawData.CmdLists[DrawListIdx];
+		for (const ImDrawCmd& DrawCmd : DrawList.CmdBuffer)
+		{
+			const FSlateRect ClipRect = GetVisibleClipRect(DrawCmd.ClipRect, Translation, TargetRect);
+			if (DrawCmd.ElemCount == 0 || IsRectEmpty(ClipRect))
+			{
+				continue;
+			}
+
+			FImGuiPS::FParameters PSParameters;
+			PSParameters.Texture = Snapshot->FindTexture(DrawCmd.TextureId);
+			PSParameters.Sampler = TStaticSamplerState<SF_Bilinear>::GetRHI();
+			SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), PSParameters);
+
+			RHICmdList.SetScissorRect(
+				true,
+				FMath::FloorToInt32(ClipRect.Left),
+				FMath::FloorToInt32(ClipRect.Top),
+				FMath::CeilToInt32(ClipRect.Right),
+				FMath::CeilToInt32(ClipRect.Bottom));
+			RHICmdList.DrawIndexedPrimitive(
+				IndexBuffer,
+				GlobalVtxOffset + DrawCmd.VtxOffset,
+				0,
+				DrawList.VtxBuffer.Size - DrawCmd.VtxOffset,
+				GlobalIdxOffset + DrawCmd.IdxOffset,
+				DrawCmd.ElemCount / 3,
+				1);
+		}
+		GlobalVtxOffset += DrawList.VtxBuffer.Size;
+		GlobalIdxOffset += DrawList.IdxBuffer.Size;
 	}
+
+	RHICmdList.SetScissorRect(false, 0, 0, 0, 0);
+	RHICmdList.EndRenderPass();
+
+	// @NOTE: Keep the snapshot, invalidation panels and global invalidation replay cached elements without painting
+	// the canvas again. The canvas releases it once Slate let go of the element, see SImGuiCanvas::UpdateDrawData
+}
+
+// Returns an entry of Pool that nothing else references anymore, or a new one. Reusing entries keeps the buffers
+// they own alive across frames.
+template <typename ObjectType>
+static TSharedRef<ObjectType, ESPMode::ThreadSafe> AcquireFromPool(TArray<TSharedRef<ObjectType, ESPMode::ThreadSafe>>& Pool)
+{
+	for (const TSharedRef<ObjectType, ESPMode::ThreadSafe>& Entry : Pool)
+	{
+		if (Entry.GetSharedReferenceCount() == 1)
+		{
+			return Entry;
+		}
+	}
+	return Pool.Add_GetRef(MakeShared<ObjectType, ESPMode::ThreadSafe>());
 }
 	
 static EMouseCursor::Type ImguiToSlateCursor(ImGuiMouseCursor ImGuiCursor)
@@ -193,6 +1093,42 @@ static ImGuiKey SlateToImGuiKey(const FKey& Key)
 }
 }
 
+// Input of a canvas whose context is built on the ImGui thread. Events are recorded on the game thread and applied
+// before the next frame, the capture flags are the ones of the last frame built
+struct FImGuiInputQueue
+{
+	void Push(TFunction<void(ImGuiIO&)>&& Event)
+	{
+		FScopeLock ScopeLock(&Lock);
+		Events.Add(MoveTemp(Event));
+	}
+
+	void Apply(ImGuiIO& IO)
+	{
+		{
+			FScopeLock ScopeLock(&Lock);
+			Swap(Events, ApplyingEvents);
+		}
+		for (const TFunction<void(ImGuiIO&)>& Event : ApplyingEvents)
+		{
+			Event(IO);
+		}
+		ApplyingEvents.Reset();
+
+		bWantCaptureMouse = IO.WantCaptureMouse;
+		bWantCaptureKeyboard = IO.WantCaptureKeyboard;
+		bWantTextInput = IO.WantTextInput;
+	}
+
+	std::atomic<bool> bWantCaptureMouse = false;
+	std::atomic<bool> bWantCaptureKeyboard = false;
+	std::atomic<bool> bWantTextInput = false;
+
+private:
+	FCriticalSection Lock;
+	TArray<TFunction<void(ImGuiIO&)>> Events;
+	TArray<TFunction<void(ImGuiIO&)>> ApplyingEvents; // ImGui thread only
+};
 
 class SImGuiCanvas : public SLeafWidget
 {
@@ -200,12 +1136,14 @@ class SImGuiCanvas : public SLeafWidget
 
 public:
 	SLATE_BEGIN_ARGS(SImGuiCanvas)
-			: _ViewportID(-1), _Identifier()
+			: _ViewportID(-1), _Identifier(), _Context(nullptr)
 		{
 		}
 
 		SLATE_ATTRIBUTE(ImGuiID, ViewportID)
 		SLATE_ATTRIBUTE(FName, Identifier)
+		SLATE_ARGUMENT(ImGuiContext*, Context) // The current context when unset
+		SLATE_ARGUMENT(TSharedPtr<FImGuiInputQueue>, InputQueue) // Set when the context is built on the ImGui thread
 	SLATE_END_ARGS()
 
 	void Construct(const FArguments& InArgs);
@@ -236,13 +1174,59 @@ public:
 	virtual FReply OnKeyChar(const FGeometry& MyGeometry, const FCharacterEvent& InCharacterEvent) override;
 	
 	void UpdateDrawData(ImDrawData* InDrawData);
+	void ClearContext() { Context = nullptr; InputQueue.Reset(); PendingMousePosition.Reset(); }
+	// Reconnects a canvas taken out of the window pool to a new viewport, dropping the draw data of the previous one
+	void SetContext(ImGuiContext* InContext, ImGuiID InViewportID);
+
+	// Forwards the mouse position held back by ImGui.Input.CoalesceMouseMoves, before the context starts a new frame
+	void FlushPendingInput();
 	void SetDesiredCursor(EMouseCursor::Type InCursor) { DesiredCursor = InCursor; }
 
+	// Converts draw lists ahead of paint with the geometry of the last paint, PrepareGeometry(DrawListIdx) can be called
+	// concurrently for different draw lists once BeginPrepareGeometry returned their count. Canvases that didn't paint
+	// on the last frame, or have nothing new to paint, return 0
+	int32 BeginPrepareGeometry();
+	void PrepareGeometry(int32 DrawListIdx);
+
+	// Draw commands culled against the canvas culling rect and submitted to Slate on the last paint
+	int32 GetNumCulledDrawCmds() const { return NumCulledDrawCmds; }
+	int32 GetNumSubmittedDrawCmds() const { return NumSubmittedDrawCmds; }
+
+private:
+	bool UpdateCachedDrawList(int32 DrawListIdx, const FVector2f& VertexTranslation) const;
+
+	// Returns false when the canvas has no context to forward input to anymore. Any pending mouse position is forwarded
+	// first so ImGui sees events in the order Slate sent them
+	template <typename FuncType>
+	bool ForwardInput(FuncType&& Event);
+	template <typename FuncType>
+	bool SendInput(FuncType&& Event);
+	bool WantCaptureMouse() const;
+	bool WantCaptureKeyboard() const;
+	bool WantTextInput() const;
+
 private:
+	ImGuiContext* Context = nullptr; // Context input is forwarded to, the current one when the canvas was created
+	TSharedPtr<FImGuiInputQueue> InputQueue;
 	ImGuiID ViewportID;
 	FName Identifier;
 	ImGuiInterop::FImGuiDrawData DrawData = {};
+	mutable TArray<ImGuiInterop::FImGuiCachedDrawList> GeometryCache; // One entry per draw list index
+	mutable int32 GeometryCacheHighWaterMark = 0;
+	mutable int32 PaintsSinceGeometryCacheTrim = 0;
+	mutable TOptional<FVector2f> LastPaintTranslation; // Window space translation of the canvas on its last paint
+	mutable FSlateRect LastPaintCullingRect;
+	mutable uint64 LastPaintFrame = 0; // GFrameCounter of the last paint
+	mutable uint64 LastPaintHash = 0; // Hash of the draw data painted last
+	mutable int32 NumCulledDrawCmds = 0;
+	mutable int32 NumSubmittedDrawCmds = 0;
+
+	// ImGui.Canvas.RenderThreadDraw, the snapshot replaces DrawData
+	TSharedPtr<ImGuiInterop::FImGuiDrawDataSnapshot, ESPMode::ThreadSafe> Snapshot;
+	TArray<TSharedRef<ImGuiInterop::FImGuiDrawDataSnapshot, ESPMode::ThreadSafe>> SnapshotPool;
+	mutable TArray<TSharedRef<ImGuiInterop::FImGuiSlateElement, ESPMode::ThreadSafe>> ElementPool;
 	FVector2f CachedPosition;
+	TOptional<FVector2f> PendingMousePosition; // Last mouse move not forwarded yet, see ImGui.Input.CoalesceMouseMoves
 	EMouseCursor::Type DesiredCursor = EMouseCursor::Default;
 	int DisableThrottling = 0;
 };
@@ -257,75 +1241,171 @@ void SImGuiCanvas::Construct(const FArguments& InArgs)
 {
 	ViewportID = InArgs._ViewportID.Get();
 	Identifier = InArgs._Identifier.Get();
+	Context = InArgs._Context ? InArgs._Context : ImGui::GetCurrentContext();
+	InputQueue = InArgs._InputQueue;
 
 	SetVisibility(EVisibility::Visible);
 }
 
+void SImGuiCanvas::SetContext(ImGuiContext* InContext, ImGuiID InViewportID)
+{
+	Context = InContext;
+	ViewportID = InViewportID;
+	DrawData.CmdListsCount = 0;
+	DrawData.Hash = 0;
+	Snapshot.Reset();
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
 int32 SImGuiCanvas::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
                             FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle,
                             bool bParentEnabled) const
 {
+	IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_CanvasPaint, "ImGui Canvas Paint");
+	FImGuiPerfScope PerfScope(EImGuiPerfTimer::CanvasPaint);
 	static const FSlateColorBrush SolidWhiteBrush = FSlateColorBrush(FColorList::White);
 
+	if (Snapshot)
+	{
+		const TSharedRef<ImGuiInterop::FImGuiSlateElement, ESPMode::ThreadSafe> Element = ImGuiInterop::AcquireFromPool(ElementPool);
+		Element->Snapshot = Snapshot;
+		Element->Translation = FVector2f(AllottedGeometry.GetAccumulatedRenderTransform().GetTranslation())
+			- FVector2f{Snapshot->DrawData.DisplayPos.x, Snapshot->DrawData.DisplayPos.y};
+		Element->CullingRect = MyCullingRect;
+		FSlateDrawElement::MakeCustom(OutDrawElements, LayerId, Element);
+		return LayerId;
+	}
+
 	// @NOTE: We only use the translation since we're outputting vertices in local space with scaling ignored
 	// we also need to offset by DisplayPos since the vertices are in Desktop space
 	FSlateRenderTransform GeoRenderTransform = AllottedGeometry.GetAccumulatedRenderTransform();
 	GeoRenderTransform = GeoRenderTransform.GetTranslation() - FVector2D{DrawData.DisplayPos.x, DrawData.DisplayPos.y};
+	const FVector2f VertexTranslation = GeoRenderTransform.GetTranslation();
+	LastPaintTranslation = AllottedGeometry.GetAccumulatedRenderTransform().GetTranslation();
+	LastPaintCullingRect = MyCullingRect;
+	LastPaintFrame = GFrameCounter;
+	LastPaintHash = DrawData.Hash;
+
+	if (GeometryCache.Num() < DrawData.CmdListsCount)
+	{
+		GeometryCache.SetNum(DrawData.CmdListsCount);
+	}
+
+	NumCulledDrawCmds = 0;
+	NumSubmittedDrawCmds = 0;
 
 	for (int DrawListIdx = 0; DrawListIdx < DrawData.CmdListsCount; ++DrawListIdx)
 	{
+		// Don't even convert draw lists that are entirely scrolled or clipped out
 		const ImGuiInterop::FImGuiDrawList& DrawList = DrawData.CmdLists[DrawListIdx];
-
-		TArray<FSlateVertex> VertexBuffer;
-		VertexBuffer.SetNumUninitialized(DrawList.VtxBuffer.Num(), false);
-		for (int VtxIndex = 0; VtxIndex < DrawList.VtxBuffer.Num(); ++VtxIndex)
+		if (!ImGuiInterop::IsAnyCommandVisible(DrawList, VertexTranslation, MyCullingRect))
 		{
-			const ImDrawVert& Vtx = DrawList.VtxBuffer[VtxIndex];
-			ImVec4 Color = ImGui::ColorConvertU32ToFloat4(Vtx.col);
-			FLinearColor LinearColor = {Color.x, Color.y, Color.z, Color.w};
-			VertexBuffer[VtxIndex] = FSlateVertex::Make<ESlateVertexRounding::Enabled>(
-				GeoRenderTransform,
-				FVector2f{Vtx.pos.x, Vtx.pos.y},
-				FVector2f{Vtx.uv.x, Vtx.uv.y},
-				FVector2f{1.0f, 1.0f},
-				LinearColor.ToFColor(false));
+			NumCulledDrawCmds += DrawList.CmdBuffer.Size;
+			continue;
 		}
 
-		TArray<SlateIndex> IndexBuffer;
-		for (int CmdIndex = 0; CmdIndex < DrawList.CmdBuffer.Num(); ++CmdIndex)
+		UpdateCachedDrawList(DrawListIdx, VertexTranslation);
+		const ImGuiInterop::FImGuiCachedDrawList& CachedDrawList = GeometryCache[DrawListIdx];
+		for (int CmdIndex = 0; CmdIndex < CachedDrawList.NumCmds; ++CmdIndex)
 		{
-			const ImDrawCmd& DrawCmd = DrawList.CmdBuffer[CmdIndex];
+			const ImGuiInterop::FImGuiCachedDrawCmd& CachedCmd = CachedDrawList.Cmds[CmdIndex];
+			const FSlateRect ClippingRect = ImGuiInterop::GetVisibleClipRect(CachedCmd.ClipRect, VertexTranslation, MyCullingRect);
+			if (ImGuiInterop::IsRectEmpty(ClippingRect))
+			{
+				NumCulledDrawCmds++;
+				continue;
+			}
+			NumSubmittedDrawCmds++;
 
-			FSlateBrush* Brush = (FSlateBrush*)DrawCmd.TextureId;
+			const TArray<FSlateVertex>& VertexBuffer = CachedCmd.Vertices.GetBuffer();
+			const TArray<SlateIndex>& IndexBuffer = CachedCmd.Indices.GetBuffer();
+
+			FSlateBrush* Brush = (FSlateBrush*)CachedCmd.TextureId;
 			const FSlateResourceHandle& Handle = Brush
 				                                     ? Brush->GetRenderingResource()
 				                                     : SolidWhiteBrush.GetRenderingResource();
 
-			IndexBuffer.SetNumUninitialized(DrawCmd.ElemCount, false);
-			for (int ElemIndex = 0; ElemIndex < static_cast<int>(DrawCmd.ElemCount); ++ElemIndex)
-			{
-				IndexBuffer[ElemIndex] = DrawList.IdxBuffer[DrawCmd.IdxOffset + ElemIndex];
-			}
-
-			FVector2f ClippingRectTopLeft = {DrawCmd.ClipRect.x, DrawCmd.ClipRect.y};
-			ClippingRectTopLeft = GeoRenderTransform.TransformPoint(ClippingRectTopLeft);
-			FVector2f ClippingRectBottomRight = {DrawCmd.ClipRect.z, DrawCmd.ClipRect.w};
-			ClippingRectBottomRight = GeoRenderTransform.TransformPoint(ClippingRectBottomRight);
-			FSlateRect ClippingRect = FSlateRect(
-				ClippingRectTopLeft.X,
-				ClippingRectTopLeft.Y,
-				ClippingRectBottomRight.X,
-				ClippingRectBottomRight.Y);
-
-			ClippingRect = ClippingRect.IntersectionWith(MyCullingRect);
 			OutDrawElements.PushClip(FSlateClippingZone{ClippingRect});
 			FSlateDrawElement::MakeCustomVerts(OutDrawElements, LayerId, Handle, VertexBuffer, IndexBuffer, nullptr, 0, 0);
 			OutDrawElements.PopClip();
+			INC_DWORD_STAT_BY(STAT_ImGui_BytesSubmitted, VertexBuffer.Num() * sizeof(FSlateVertex) + IndexBuffer.Num() * sizeof(SlateIndex));
+			// @NOTE: The custom verts payload copies the vertices and the indices into arrays of its own
+			INC_DWORD_STAT_BY(STAT_ImGui_SlateElementAllocations, 2);
 		}
 	}
 
-	return LayerId;
-}
+	// @NOTE: Culled draw lists and commands still age their arenas, entries unused for a while are released
+	for (ImGuiInterop::FImGuiCachedDrawList& CachedDrawList : GeometryCache)
+	{
+		CachedDrawList.EndFrame();
+	}
+	GeometryCacheHighWaterMark = FMath::Max(GeometryCacheHighWaterMark, DrawData.CmdListsCount);
+	if (++PaintsSinceGeometryCacheTrim >= ImGuiInterop::FImGuiCachedDrawList::TrimPeriod)
+	{
+		if (GeometryCache.Num() > GeometryCacheHighWaterMark)
+		{
+			GeometryCache.SetNum(GeometryCacheHighWaterMark);
+		}
+		GeometryCacheHighWaterMark = 0;
+		PaintsSinceGeometryCacheTrim = 0;
+	}
+
+	INC_DWORD_STAT_BY(STAT_ImGui_DrawCmdsCulled, NumCulledDrawCmds);
+	INC_DWORD_STAT_BY(STAT_ImGui_DrawCmdsSubmitted, NumSubmittedDrawCmds);
+
+	return LayerId;
+}
+
+bool SImGuiCanvas::UpdateCachedDrawList(int32 DrawListIdx, const FVector2f& VertexTranslation) const
+{
+	const ImGuiInterop::FImGuiDrawList& DrawList = DrawData.CmdLists[DrawListIdx];
+	ImGuiInterop::FImGuiCachedDrawList& CachedDrawList = GeometryCache[DrawListIdx];
+
+	if (!GImGuiReuseUnchangedGeometry
+		|| !CachedDrawList.bValid
+		|| CachedDrawList.Generation != GImGuiGeometryCacheGeneration
+		|| CachedDrawList.Hash != DrawList.Hash
+		|| CachedDrawList.Translation != VertexTranslation)
+	{
+		CachedDrawList.Build(DrawList, VertexTranslation);
+		INC_DWORD_STAT(STAT_ImGui_DrawListsConverted);
+		return true;
+	}
+
+	INC_DWORD_STAT(STAT_ImGui_DrawListsReused);
+	return false;
+}
+
+int32 SImGuiCanvas::BeginPrepareGeometry()
+{
+	// Nothing to predict the translation from until the canvas got painted once
+	if (Snapshot || !LastPaintTranslation.IsSet())
+	{
+		return 0;
+	}
+
+	// @NOTE: Hidden canvases (collapsed tabs, closed panels) stop painting, and retained canvases only paint again on
+	// new draw data. Leave them to convert lazily in OnPaint if they ever do.
+	if (GFrameCounter - LastPaintFrame > 1 || DrawData.Hash == LastPaintHash)
+	{
+		return 0;
+	}
+
+	if (GeometryCache.Num() < DrawData.CmdListsCount)
+	{
+		GeometryCache.SetNum(DrawData.CmdListsCount);
+	}
+	return DrawData.CmdListsCount;
+}
+
+void SImGuiCanvas::PrepareGeometry(int32 DrawListIdx)
+{
+	const FVector2f VertexTranslation = LastPaintTranslation.GetValue() - FVector2f{DrawData.DisplayPos.x, DrawData.DisplayPos.y};
+	if (ImGuiInterop::IsAnyCommandVisible(DrawData.CmdLists[DrawListIdx], VertexTranslation, LastPaintCullingRect))
+	{
+		UpdateCachedDrawList(DrawListIdx, VertexTranslation);
+	}
+}
 
 FVector2D SImGuiCanvas::ComputeDesiredSize(float) const
 {
@@ -339,22 +1419,22 @@ bool SImGuiCanvas::SupportsKeyboardFocus() const
 
 FReply SImGuiCanvas::OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
 {
-	ImGuiIO& IO = ImGui::GetIO();
 	const FKey EffectingButton = MouseEvent.GetEffectingButton();
+	bool bForwarded = false;
 	if (EffectingButton == EKeys::LeftMouseButton)
 	{
-		IO.AddMouseButtonEvent(ImGuiMouseButton_Left, true);
+		bForwarded = ForwardInput([](ImGuiIO& IO) { IO.AddMouseButtonEvent(ImGuiMouseButton_Left, true); });
 	}
 	else if (EffectingButton == EKeys::RightMouseButton)
 	{
-		IO.AddMouseButtonEvent(ImGuiMouseButton_Right, true);
+		bForwarded = ForwardInput([](ImGuiIO& IO) { IO.AddMouseButtonEvent(ImGuiMouseButton_Right, true); });
 	}
 	else if (EffectingButton == EKeys::MiddleMouseButton)
 	{
-		IO.AddMouseButtonEvent(ImGuiMouseButton_Middle, true);
+		bForwarded = ForwardInput([](ImGuiIO& IO) { IO.AddMouseButtonEvent(ImGuiMouseButton_Middle, true); });
 	}
 
-	if (IO.WantCaptureMouse)
+	if (bForwarded && WantCaptureMouse())
 	{
 		FSlateThrottleManager::Get().DisableThrottle(true);
 		DisableThrottling++;
@@ -373,20 +1453,19 @@ TOptional<EMouseCursor::Type> SImGuiCanvas::GetCursor() const
 
 FReply SImGuiCanvas::OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
 {
-	ImGuiIO& IO = ImGui::GetIO();
 	const FKey EffectingButton = MouseEvent.GetEffectingButton();
 
 	if (EffectingButton == EKeys::LeftMouseButton)
 	{
-		IO.AddMouseButtonEvent(ImGuiMouseButton_Left, false);
+		ForwardInput([](ImGuiIO& IO) { IO.AddMouseButtonEvent(ImGuiMouseButton_Left, false); });
 	}
 	else if (EffectingButton == EKeys::RightMouseButton)
 	{
-		IO.AddMouseButtonEvent(ImGuiMouseButton_Right, false);
+		ForwardInput([](ImGuiIO& IO) { IO.AddMouseButtonEvent(ImGuiMouseButton_Right, false); });
 	}
 	else if (EffectingButton == EKeys::MiddleMouseButton)
 	{
-		IO.AddMouseButtonEvent(ImGuiMouseButton_Middle, false);
+		ForwardInput([](ImGuiIO& IO) { IO.AddMouseButtonEvent(ImGuiMouseButton_Middle, false); });
 	}
 
 	if (HasMouseCapture())
@@ -406,9 +1485,23 @@ FReply SImGuiCanvas::OnMouseButtonUp(const FGeometry& MyGeometry, const FPointer
 
 FReply SImGuiCanvas::OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
 {
-	ImGuiIO& IO = ImGui::GetIO();
+	// @NOTE: Contexts built on the ImGui thread have no platform windows, their display starts at the canvas
 	FVector2f Position = MouseEvent.GetScreenSpacePosition();
-	IO.AddMousePosEvent(Position.X, Position.Y);
+	if (InputQueue)
+	{
+		Position -= MyGeometry.GetAbsolutePosition();
+	}
+	INC_DWORD_STAT(STAT_ImGui_MouseMovesReceived);
+	if (GImGuiCoalesceMouseMoves && (Context || InputQueue))
+	{
+		// @NOTE: Only the last position of a run of moves matters to ImGui, high polling rate mice send hundreds per frame
+		PendingMousePosition = Position;
+	}
+	else
+	{
+		ForwardInput([Position](ImGuiIO& IO) { IO.AddMousePosEvent(Position.X, Position.Y); });
+		INC_DWORD_STAT(STAT_ImGui_MouseMovesForwarded);
+	}
 
 	CachedPosition = Position;
 	return FReply::Handled();
@@ -416,8 +1509,7 @@ FReply SImGuiCanvas::OnMouseMove(const FGeometry& MyGeometry, const FPointerEven
 
 void SImGuiCanvas::OnMouseEnter(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
 {
-	ImGuiIO& IO = ImGui::GetIO();
-	IO.AddMouseViewportEvent(ViewportID);
+	ForwardInput([ViewportID = ViewportID](ImGuiIO& IO) { IO.AddMouseViewportEvent(ViewportID); });
 }
 
 void SImGuiCanvas::OnMouseLeave(const FPointerEvent& MouseEvent)
@@ -426,8 +1518,7 @@ void SImGuiCanvas::OnMouseLeave(const FPointerEvent& MouseEvent)
 	// but also it's unclear if we're on an other window or something... Might just be simpler to leave this as is
 	if(!HasMouseCapture())
 	{
-		ImGuiIO& IO = ImGui::GetIO();
-		IO.AddMousePosEvent(-FLT_MAX, -FLT_MAX);
+		ForwardInput([](ImGuiIO& IO) { IO.AddMousePosEvent(-FLT_MAX, -FLT_MAX); });
 	}
 }
 
@@ -438,10 +1529,8 @@ void SImGuiCanvas::OnMouseCaptureLost(const FCaptureLostEvent& CaptureLostEvent)
 
 FReply SImGuiCanvas::OnKeyDown(const FGeometry& MyGeometry, const FKeyEvent& InKeyEvent)
 {
-	ImGuiIO& IO = ImGui::GetIO();
-	IO.AddKeyEvent(ImGuiInterop::SlateToImGuiKey(InKeyEvent.GetKey()), true);
-
-	if(IO.WantCaptureKeyboard)
+	const ImGuiKey Key = ImGuiInterop::SlateToImGuiKey(InKeyEvent.GetKey());
+	if(ForwardInput([Key](ImGuiIO& IO) { IO.AddKeyEvent(Key, true); }) && WantCaptureKeyboard())
 	{
 		return FReply::Handled();
 	}
@@ -453,10 +1542,8 @@ FReply SImGuiCanvas::OnKeyDown(const FGeometry& MyGeometry, const FKeyEvent& InK
 
 FReply SImGuiCanvas::OnKeyUp(const FGeometry& MyGeometry, const FKeyEvent& InKeyEvent)
 {
-	ImGuiIO& IO = ImGui::GetIO();
-	IO.AddKeyEvent(ImGuiInterop::SlateToImGuiKey(InKeyEvent.GetKey()), false);
-
-	if(IO.WantCaptureKeyboard)
+	const ImGuiKey Key = ImGuiInterop::SlateToImGuiKey(InKeyEvent.GetKey());
+	if(ForwardInput([Key](ImGuiIO& IO) { IO.AddKeyEvent(Key, false); }) && WantCaptureKeyboard())
 	{
 		return FReply::Handled();
 	}
@@ -468,9 +1555,8 @@ FReply SImGuiCanvas::OnKeyUp(const FGeometry& MyGeometry, const FKeyEvent& InKey
 
 FReply SImGuiCanvas::OnKeyChar(const FGeometry& MyGeometry, const FCharacterEvent& InCharacterEvent)
 {
-	ImGuiIO& IO = ImGui::GetIO();
-	IO.AddInputCharacterUTF16(InCharacterEvent.GetCharacter());
-	if(IO.WantTextInput)
+	const TCHAR Character = InCharacterEvent.GetCharacter();
+	if(ForwardInput([Character](ImGuiIO& IO) { IO.AddInputCharacterUTF16(Character); }) && WantTextInput())
 	{
 		return FReply::Handled();
 	}
@@ -479,36 +1565,228 @@ FReply SImGuiCanvas::OnKeyChar(const FGeometry& MyGeometry, const FCharacterEven
 
 FReply SImGuiCanvas::OnMouseWheel(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
 {
-	ImGuiIO& IO = ImGui::GetIO();
-
-	IO.AddMouseWheelEvent(MouseEvent.GetGestureDelta().X, MouseEvent.GetWheelDelta());
-	if (IO.WantCaptureMouse)
+	const FVector2f WheelDelta = {MouseEvent.GetGestureDelta().X, MouseEvent.GetWheelDelta()};
+	if (ForwardInput([WheelDelta](ImGuiIO& IO) { IO.AddMouseWheelEvent(WheelDelta.X, WheelDelta.Y); }) && WantCaptureMouse())
 	{
 		return FReply::Handled();
 	}
 	return FReply::Unhandled();
 }
 
+void SImGuiCanvas::FlushPendingInput()
+{
+	if (PendingMousePosition)
+	{
+		const FVector2f Position = *PendingMousePosition;
+		PendingMousePosition.Reset();
+		SendInput([Position](ImGuiIO& IO) { IO.AddMousePosEvent(Position.X, Position.Y); });
+		INC_DWORD_STAT(STAT_ImGui_MouseMovesForwarded);
+	}
+}
+
+template <typename FuncType>
+bool SImGuiCanvas::ForwardInput(FuncType&& Event)
+{
+	FlushPendingInput();
+	return SendInput(Forward<FuncType>(Event));
+}
+
+template <typename FuncType>
+bool SImGuiCanvas::SendInput(FuncType&& Event)
+{
+	IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_InputForwarding, "ImGui Input Forwarding");
+	if (InputQueue)
+	{
+		InputQueue->Push(Forward<FuncType>(Event));
+		return true;
+	}
+	if (Context)
+	{
+		Event(Context->IO);
+		return true;
+	}
+	return false;
+}
+
+bool SImGuiCanvas::WantCaptureMouse() const
+{
+	return InputQueue ? InputQueue->bWantCaptureMouse.load() : Context && Context->IO.WantCaptureMouse;
+}
+
+bool SImGuiCanvas::WantCaptureKeyboard() const
+{
+	return InputQueue ? InputQueue->bWantCaptureKeyboard.load() : Context && Context->IO.WantCaptureKeyboard;
+}
+
+bool SImGuiCanvas::WantTextInput() const
+{
+	return InputQueue ? InputQueue->bWantTextInput.load() : Context && Context->IO.WantTextInput;
+}
+
 void SImGuiCanvas::UpdateDrawData(ImDrawData* InDrawData)
 {
-	DrawData.Set(InDrawData);
+	IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_DrawDataHandoff, "ImGui Draw Data Handoff");
+	// @NOTE: Only invalidate on new content so the canvas can take part in global invalidation and invalidation panels
+	uint64 PreviousHash = DrawData.Hash;
+	uint64 NewHash;
+	if (GImGuiRenderThreadDraw)
+	{
+		PreviousHash = Snapshot ? Snapshot->DrawData.Hash : 0;
+		// Elements Slate doesn't reference anymore won't be drawn again, free their snapshot so it can be recycled
+		for (const TSharedRef<ImGuiInterop::FImGuiSlateElement, ESPMode::ThreadSafe>& Element : ElementPool)
+		{
+			if (Element.GetSharedReferenceCount() == 1)
+			{
+				Element->Snapshot.Reset();
+			}
+		}
+		TSharedRef<ImGuiInterop::FImGuiDrawDataSnapshot, ESPMode::ThreadSafe> NewSnapshot = ImGuiInterop::AcquireFromPool(SnapshotPool);
+		NewSnapshot->DrawData.Set(InDrawData);
+		NewSnapshot->ResolveTextures();
+		Snapshot = NewSnapshot;
+		NewHash = Snapshot->DrawData.Hash;
+	}
+	else
+	{
+		Snapshot.Reset();
+		DrawData.Set(InDrawData);
+		NewHash = DrawData.Hash;
+	}
+
+	if (NewHash != PreviousHash)
+	{
+		Invalidate(EInvalidateWidgetReason::Paint);
+		INC_DWORD_STAT(STAT_ImGui_CanvasInvalidations);
+	}
+}
+
+// Widget to insert in the hierarchy for a canvas, in retained mode the invalidation panel caches the canvas elements
+static TSharedRef<SWidget> MakeCanvasHost(const TSharedRef<SImGuiCanvas>& Canvas)
+{
+	if (GImGuiRetainedCanvas)
+	{
+		return SNew(SInvalidationPanel)
+			[
+				Canvas
+			];
+	}
+	return Canvas;
 }
 
+static void ImGui_ImplUnreal_TrimWindowPool(int32 MaxSize);
+static void ImGui_ImplUnreal_ShutdownMonitors();
+
 void UImGuiSubsystem::Deinitialize()
 {
-	ImPlot::DestroyContext();
-	ImGui::DestroyContext();
+	if (FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().OnPreTick().RemoveAll(this);
+		FSlateApplication::Get().OnPostTick().RemoveAll(this);
+	}
+	FWorldDelegates::OnWorldInitializedActors.RemoveAll(this);
+	FWorldDelegates::OnWorldTickStart.RemoveAll(this);
+	FWorldDelegates::OnWorldPostActorTick.RemoveAll(this);
+	WorldTickContextScope.Reset();
+
+	Thread.Reset();
+	StopDrawReplay();
+	DrawCapture.Reset();
+	FImGuiDeferredDraw::DiscardSubmitted();
+	ImGui_ImplUnreal_TrimWindowPool(0);
+	ImGui_ImplUnreal_ShutdownMonitors();
+
+	for (const TUniquePtr<FImGuiViewportContext>& ViewportContext : Contexts)
+	{
+		DestroyContext(*ViewportContext);
+	}
+	Contexts.Reset();
+
+	IM_DELETE(FontAtlas);
+	FontAtlas = nullptr;
 }
 
+// Platform window state requested by ImGui during the frame
+struct ImGui_ImplUnreal_WindowState
+{
+	TOptional<FVector2f> Position;
+	TOptional<FVector2f> Size;
+	TOptional<FString> Title;
+	TOptional<float> Alpha;
+};
+
 struct ImGui_ImplUnreal_ViewportData
 {
 	SWindow* HwndParent = nullptr;
 	TSharedPtr<SWindow> Hwnd = nullptr;
 	TSharedPtr<SImGuiCanvas> Canvas = nullptr;
 
+	// Main viewport only, the game viewport the canvas has been added to
+	TWeakObjectPtr<UGameViewportClient> GameViewport;
+	TSharedPtr<SWidget> CanvasHost;
+
 	bool bHwndOwned = false;
+
+	// @NOTE: Requests are applied once after UpdatePlatformWindows, and only when they differ from the state of the
+	// SWindow, see ImGui_ImplUnreal_FlushWindowUpdates
+	ImGui_ImplUnreal_WindowState PendingState;
+	FVector2f CachedPosition = FVector2f::ZeroVector;
+	uint64 CachedPositionFrame = MAX_uint64;
+
+	// The canvas kept the draw data of an older frame because the viewport was hidden, see ImGui_ImplUnreal_RenderWindow
+	bool bDrawDataSkipped = false;
 };
 
+// Sets Pending to Value, a request replacing another one not applied yet is a native call avoided
+template <typename T, typename ValueType>
+static void ImGui_ImplUnreal_RequestWindowState(TOptional<T>& Pending, ValueType&& Value)
+{
+	if (Pending)
+	{
+		INC_DWORD_STAT(STAT_ImGui_NativeWindowCallsAvoided);
+	}
+	Pending = Forward<ValueType>(Value);
+}
+
+// Takes Pending, and returns it when it differs from the current state of the window GetCurrent reads
+template <typename T, typename GetterType>
+static TOptional<T> ImGui_ImplUnreal_ConsumeWindowState(TOptional<T>& Pending, GetterType&& GetCurrent)
+{
+	TOptional<T> Value = MoveTemp(Pending);
+	Pending.Reset();
+	if (!Value)
+	{
+		return Value;
+	}
+	if (*Value == GetCurrent())
+	{
+		INC_DWORD_STAT(STAT_ImGui_NativeWindowCallsAvoided);
+		Value.Reset();
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_ImGui_NativeWindowCalls);
+	}
+	return Value;
+}
+
+// Disconnects the canvas from its context, the canvas widget can outlive it until Slate destroys it. The main viewport
+// canvas is also removed from its game viewport
+static void ImGui_ImplUnreal_ReleaseCanvas(ImGui_ImplUnreal_ViewportData* vd)
+{
+	if (UGameViewportClient* GameViewport = vd->GameViewport.Get(); GameViewport && vd->CanvasHost)
+	{
+		GameViewport->RemoveViewportWidgetContent(vd->CanvasHost.ToSharedRef());
+	}
+	if (vd->Canvas)
+	{
+		vd->Canvas->ClearContext();
+	}
+	vd->GameViewport = nullptr;
+	vd->CanvasHost = nullptr;
+	vd->Canvas = nullptr;
+	vd->Hwnd = nullptr;
+}
+
 static SWindow* ImGui_ImplUnreal_GetHwndFromViewportID(ImGuiID ID)
 {
 	if (ID != 0)
@@ -522,14 +1800,85 @@ static SWindow* ImGui_ImplUnreal_GetHwndFromViewportID(ImGuiID ID)
 	return nullptr;
 }
 
-static void ImGui_ImplUnreal_UpdateMonitors()
+// Monitors of the display metrics last reported by the platform application, only replaced when the layout changed
+static TArray<FMonitorInfo> GImGuiMonitors;
+static uint32 GImGuiMonitorsRevision = 0;
+static FDelegateHandle GImGuiDisplayMetricsChangedHandle;
+
+static bool ImGui_ImplUnreal_IsSameMonitorLayout(const TArray<FMonitorInfo>& A, const TArray<FMonitorInfo>& B)
 {
-	FDisplayMetrics DisplayMetrics;
+	if (A.Num() != B.Num())
+	{
+		return false;
+	}
+
+	const auto IsSameRect = [](const FPlatformRect& RectA, const FPlatformRect& RectB)
+	{
+		return RectA.Left == RectB.Left && RectA.Top == RectB.Top && RectA.Right == RectB.Right && RectA.Bottom == RectB.Bottom;
+	};
+	for (int32 MonitorIdx = 0; MonitorIdx < A.Num(); ++MonitorIdx)
+	{
+		const FMonitorInfo& MonitorA = A[MonitorIdx];
+		const FMonitorInfo& MonitorB = B[MonitorIdx];
+		if (!IsSameRect(MonitorA.DisplayRect, MonitorB.DisplayRect) || !IsSameRect(MonitorA.WorkArea, MonitorB.WorkArea)
+			|| MonitorA.DPI != MonitorB.DPI || MonitorA.bIsPrimary != MonitorB.bIsPrimary)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static void ImGui_ImplUnreal_OnDisplayMetricsChanged(const FDisplayMetrics& DisplayMetrics)
+{
+	// @NOTE: Also broadcast for changes ImGui doesn't use (e.g. the title safe area), contexts only rebuild their
+	// monitors when the revision changes
+	if (GImGuiMonitorsRevision == 0 || !ImGui_ImplUnreal_IsSameMonitorLayout(GImGuiMonitors, DisplayMetrics.MonitorInfo))
+	{
+		GImGuiMonitors = DisplayMetrics.MonitorInfo;
+		++GImGuiMonitorsRevision;
+	}
+}
 
+// Builds the monitor cache once and keeps it up to date from the display metrics changes of the platform application,
+// instead of rebuilding the display metrics (which queries every monitor) whenever the monitors are needed
+static void ImGui_ImplUnreal_InitMonitors()
+{
+	FDisplayMetrics DisplayMetrics;
 	FDisplayMetrics::RebuildDisplayMetrics(DisplayMetrics);
+	ImGui_ImplUnreal_OnDisplayMetricsChanged(DisplayMetrics);
+
+	// @NOTE: Without Slate (commandlets, -nullrhi servers) the monitors stay the ones RebuildDisplayMetrics found
+	if (FSlateApplication::IsInitialized() && FSlateApplication::Get().GetPlatformApplication())
+	{
+		GImGuiDisplayMetricsChangedHandle = FSlateApplication::Get().GetPlatformApplication()->OnDisplayMetricsChanged().AddStatic(&ImGui_ImplUnreal_OnDisplayMetricsChanged);
+	}
+}
+
+static void ImGui_ImplUnreal_ShutdownMonitors()
+{
+	if (FSlateApplication::IsInitialized() && FSlateApplication::Get().GetPlatformApplication() && GImGuiDisplayMetricsChangedHandle.IsValid())
+	{
+		FSlateApplication::Get().GetPlatformApplication()->OnDisplayMetricsChanged().Remove(GImGuiDisplayMetricsChangedHandle);
+	}
+	GImGuiDisplayMetricsChangedHandle.Reset();
+	GImGuiMonitors.Reset();
+	GImGuiMonitorsRevision = 0;
+}
+
+// Rebuilds the monitors of the current context from the cache when it changed since AppliedRevision, returns whether
+// they were rebuilt. Viewports pick their monitor and DPI scale up from the new monitors on the next NewFrame
+static bool ImGui_ImplUnreal_UpdateMonitors(uint32& AppliedRevision)
+{
+	if (AppliedRevision == GImGuiMonitorsRevision)
+	{
+		return false;
+	}
+	AppliedRevision = GImGuiMonitorsRevision;
 
 	ImGuiPlatformIO& io = ImGui::GetPlatformIO();
-	for (const FMonitorInfo& MonitorInfo : DisplayMetrics.MonitorInfo)
+	io.Monitors.resize(0);
+	for (const FMonitorInfo& MonitorInfo : GImGuiMonitors)
 	{
 		ImGuiPlatformMonitor ImguiMonitor;
 		ImguiMonitor.MainPos = ImVec2((float)MonitorInfo.DisplayRect.Left, (float)MonitorInfo.DisplayRect.Top);
@@ -550,6 +1899,86 @@ static void ImGui_ImplUnreal_UpdateMonitors()
 			io.Monitors.push_back(ImguiMonitor);
 		}
 	}
+	return true;
+}
+
+// Hidden platform windows of destroyed viewports, see ImGui.Viewport.WindowPoolSize. Native windows can't change parent
+// so windows are only reused for viewports with the same parent, and the same flags in case they end up changing the
+// window setup
+struct FImGuiPooledWindow
+{
+	TSharedRef<SWindow> Window;
+	TSharedRef<SImGuiCanvas> Canvas;
+	TWeakPtr<SWindow> Parent;
+	bool bHasParent;
+	ImGuiViewportFlags Flags;
+};
+
+static constexpr ImGuiViewportFlags PooledWindowFlagsMask = ImGuiViewportFlags_NoDecoration | ImGuiViewportFlags_NoTaskBarIcon | ImGuiViewportFlags_TopMost;
+static TArray<FImGuiPooledWindow> GImGuiWindowPool;
+
+// Destroys pooled windows past MaxSize and those whose parent is gone
+static void ImGui_ImplUnreal_TrimWindowPool(int32 MaxSize)
+{
+	for (int32 Index = GImGuiWindowPool.Num() - 1; Index >= 0; --Index)
+	{
+		const FImGuiPooledWindow& Pooled = GImGuiWindowPool[Index];
+		const bool bParentGone = Pooled.bHasParent && !Pooled.Parent.IsValid();
+		if (Index >= MaxSize || bParentGone || !Pooled.Window->GetNativeWindow())
+		{
+			if (FSlateApplication::IsInitialized())
+			{
+				Pooled.Window->RequestDestroyWindow();
+			}
+			GImGuiWindowPool.RemoveAt(Index);
+		}
+	}
+	SET_DWORD_STAT(STAT_ImGui_PooledWindows, GImGuiWindowPool.Num());
+}
+
+static bool ImGui_ImplUnreal_TakePooledWindow(ImGuiViewport* Viewport, ImGui_ImplUnreal_ViewportData* VD)
+{
+	ImGui_ImplUnreal_TrimWindowPool(GImGuiWindowPoolSize);
+
+	const int32 Index = GImGuiWindowPool.IndexOfByPredicate([Viewport, VD](const FImGuiPooledWindow& Pooled)
+	{
+		return Pooled.Parent.Pin().Get() == VD->HwndParent && Pooled.bHasParent == (VD->HwndParent != nullptr) && Pooled.Flags == (Viewport->Flags & PooledWindowFlagsMask);
+	});
+	if (Index == INDEX_NONE)
+	{
+		INC_DWORD_STAT(STAT_ImGui_WindowPoolMisses);
+		return false;
+	}
+
+	VD->Hwnd = GImGuiWindowPool[Index].Window;
+	VD->Canvas = GImGuiWindowPool[Index].Canvas;
+	GImGuiWindowPool.RemoveAtSwap(Index);
+	VD->Canvas->SetContext(ImGui::GetCurrentContext(), Viewport->ID);
+	VD->Hwnd->SetOpacity(1.0f);
+	INC_DWORD_STAT(STAT_ImGui_WindowPoolHits);
+	SET_DWORD_STAT(STAT_ImGui_PooledWindows, GImGuiWindowPool.Num());
+	return true;
+}
+
+// Hides the window of a destroyed viewport to be reused, returns false when the pool is full
+static bool ImGui_ImplUnreal_PoolWindow(ImGuiViewport* Viewport, ImGui_ImplUnreal_ViewportData* VD)
+{
+	if (GImGuiWindowPool.Num() >= GImGuiWindowPoolSize || !VD->Canvas || !VD->Hwnd->GetNativeWindow())
+	{
+		return false;
+	}
+
+	TWeakPtr<SWindow> Parent;
+	if (VD->HwndParent)
+	{
+		Parent = StaticCastSharedRef<SWindow>(VD->HwndParent->AsShared());
+	}
+
+	VD->Canvas->ClearContext();
+	VD->Hwnd->HideWindow();
+	GImGuiWindowPool.Add({VD->Hwnd.ToSharedRef(), VD->Canvas.ToSharedRef(), Parent, VD->HwndParent != nullptr, Viewport->Flags & PooledWindowFlagsMask});
+	SET_DWORD_STAT(STAT_ImGui_PooledWindows, GImGuiWindowPool.Num());
+	return true;
 }
 
 static void ImGui_ImplUnreal_CreateWindow(ImGuiViewport* Viewport)
@@ -559,6 +1988,22 @@ static void ImGui_ImplUnreal_CreateWindow(ImGuiViewport* Viewport)
 
 	// Select style and parent window
 	VD->HwndParent = ImGui_ImplUnreal_GetHwndFromViewportID(Viewport->ParentViewportId);
+	VD->bHwndOwned = true;
+
+	FSlateRect WindowPosition;
+	WindowPosition.Left = Viewport->Pos.x;
+	WindowPosition.Top = Viewport->Pos.y;
+	WindowPosition.Right = WindowPosition.Left + Viewport->Size.x;
+	WindowPosition.Bottom = WindowPosition.Top + Viewport->Size.y;
+
+	// Reshape a pooled window rather than creating a native one
+	if (ImGui_ImplUnreal_TakePooledWindow(Viewport, VD))
+	{
+		VD->Hwnd->ReshapeWindow(WindowPosition);
+		Viewport->PlatformRequestResize = false;
+		Viewport->PlatformHandle = VD->Hwnd.Get();
+		return;
+	}
 
 	// Create window
 	SAssignNew(VD->Hwnd, SWindow)
@@ -573,17 +2018,10 @@ static void ImGui_ImplUnreal_CreateWindow(ImGuiViewport* Viewport)
 					.FocusWhenFirstShown(false)
 	.Content()
 	[
-		SAssignNew(VD->Canvas, SImGuiCanvas)
-		.Identifier("ImGuiWindow")
-		.ViewportID(Viewport->ID)
+		MakeCanvasHost(SAssignNew(VD->Canvas, SImGuiCanvas)
+			.Identifier("ImGuiWindow")
+			.ViewportID(Viewport->ID))
 	];
-	VD->bHwndOwned = true;
-
-	FSlateRect WindowPosition;
-	WindowPosition.Left = Viewport->Pos.x;
-	WindowPosition.Top = Viewport->Pos.y;
-	WindowPosition.Right = WindowPosition.Left + Viewport->Size.x;
-	WindowPosition.Bottom = WindowPosition.Top + Viewport->Size.y;
 	VD->Hwnd->ReshapeWindow(WindowPosition);
 
 	if (VD->HwndParent) // @TODO: This might be wrong, no idea what ParentViewportId represents exactly for now
@@ -610,12 +2048,11 @@ static void ImGui_ImplUnreal_DestroyWindow(ImGuiViewport* Viewport)
 			// @TODO: Give capture to main window
 		}
 
-		if (vd->Hwnd && vd->bHwndOwned)
+		if (vd->Hwnd && vd->bHwndOwned && !ImGui_ImplUnreal_PoolWindow(Viewport, vd))
 		{
 			vd->Hwnd->RequestDestroyWindow();
 		}
-		vd->Hwnd = nullptr;
-		vd->Canvas = nullptr;
+		ImGui_ImplUnreal_ReleaseCanvas(vd);
 		IM_DELETE(vd);
 	}
 
@@ -643,8 +2080,7 @@ static void ImGui_ImplUnreal_SetWindowPos(ImGuiViewport* Viewport, ImVec2 ImVec2
 	ImGui_ImplUnreal_ViewportData* vd = (ImGui_ImplUnreal_ViewportData*)Viewport->PlatformUserData;
 	check(vd->Hwnd);
 
-	const FVector2f NewPosition = {ImVec2.x, ImVec2.y};
-	vd->Hwnd->MoveWindowTo(NewPosition);
+	ImGui_ImplUnreal_RequestWindowState(vd->PendingState.Position, FVector2f{ImVec2.x, ImVec2.y});
 }
 
 static ImVec2 ImGui_ImplUnreal_GetWindowPos(ImGuiViewport* Viewport)
@@ -655,9 +2091,19 @@ static ImVec2 ImGui_ImplUnreal_GetWindowPos(ImGuiViewport* Viewport)
 		return ImVec2{0, 0};
 	}
 
+	// A position requested this frame wins over the geometry of the last paint, the geometry is read once per frame
+	if (vd->PendingState.Position)
+	{
+		return ImVec2{vd->PendingState.Position->X, vd->PendingState.Position->Y};
+	}
+	if (vd->CachedPositionFrame != GFrameCounter)
+	{
+		vd->CachedPosition = vd->Canvas->GetCachedGeometry().GetAbsolutePosition();
+		vd->CachedPositionFrame = GFrameCounter;
+	}
+
 	// Viewport->PlatformRequestMove = true;
-	FGeometry CachedGeometry = vd->Canvas->GetCachedGeometry();
-	FVector2f Pos = CachedGeometry.GetAbsolutePosition();
+	FVector2f Pos = vd->CachedPosition;
 	ImVec2 ImPos;
 	ImPos.x = Pos.X;
 	ImPos.y = Pos.Y;
@@ -672,7 +2118,7 @@ static ImVec2 ImGui_ImplUnreal_GetWindowSize(ImGuiViewport* Viewport)
 	ImGui_ImplUnreal_ViewportData* vd = (ImGui_ImplUnreal_ViewportData*)Viewport->PlatformUserData;
 	check(vd->Hwnd);
 
-	const FVector2f Size = vd->Hwnd->GetSizeInScreen();
+	const FVector2f Size = vd->PendingState.Size ? *vd->PendingState.Size : vd->Hwnd->GetSizeInScreen();
 
 	const ImVec2 ImSize = {Size.X, Size.Y};
 	return ImSize;
@@ -683,7 +2129,7 @@ static void ImGui_ImplUnreal_SetWindowSize(ImGuiViewport* Viewport, ImVec2 ImVec
 	ImGui_ImplUnreal_ViewportData* vd = (ImGui_ImplUnreal_ViewportData*)Viewport->PlatformUserData;
 	check(vd->Hwnd);
 
-	vd->Hwnd->Resize(FVector2f{ImVec2.x, ImVec2.y});
+	ImGui_ImplUnreal_RequestWindowState(vd->PendingState.Size, FVector2f{ImVec2.x, ImVec2.y});
 }
 
 static void ImGui_ImplUnreal_SetWindowFocus(ImGuiViewport* Viewport)
@@ -721,7 +2167,7 @@ static void ImGui_ImplUnreal_SetWindowTitle(ImGuiViewport* Viewport, const char*
 	ImGui_ImplUnreal_ViewportData* vd = (ImGui_ImplUnreal_ViewportData*)Viewport->PlatformUserData;
 	check(vd->Hwnd);
 
-	vd->Hwnd->SetTitle(FText::FromString(Arg));
+	ImGui_ImplUnreal_RequestWindowState(vd->PendingState.Title, FString(UTF8_TO_TCHAR(Arg)));
 }
 
 static void ImGui_ImplUnreal_SetWindowAlpha(ImGuiViewport* Viewport, float Alpha)
@@ -730,7 +2176,7 @@ static void ImGui_ImplUnreal_SetWindowAlpha(ImGuiViewport* Viewport, float Alpha
 	check(vd->Hwnd);
 	check(Alpha >= 0.0f && Alpha <= 1.0f);
 
-	vd->Hwnd->SetOpacity(Alpha);
+	ImGui_ImplUnreal_RequestWindowState(vd->PendingState.Alpha, Alpha);
 }
 
 static float ImGui_ImplUnreal_GetWindowDpiScale(ImGuiViewport* Viewport)
@@ -747,40 +2193,174 @@ static void ImGui_ImplUnreal_OnChangedViewport(ImGuiViewport* Viewport)
 	// @NOTE: unimplemented
 }
 
-static void ImGui_ImplUnreal_RenderWindow(ImGuiViewport* Viewport, void*)
+// Applies the window state ImGui requested during UpdatePlatformWindows to the SWindows, skipping what they already have
+static void ImGui_ImplUnreal_FlushWindowUpdates()
 {
-	ImGui_ImplUnreal_ViewportData* vd = (ImGui_ImplUnreal_ViewportData*)Viewport->PlatformUserData;
-	if (vd->Canvas)
+	for (ImGuiViewport* Viewport : ImGui::GetPlatformIO().Viewports)
 	{
-		vd->Canvas->UpdateDrawData(Viewport->DrawData);
-		vd->Canvas->SetDesiredCursor(ImGuiInterop::ImguiToSlateCursor(ImGui::GetMouseCursor()));
+		ImGui_ImplUnreal_ViewportData* vd = (ImGui_ImplUnreal_ViewportData*)Viewport->PlatformUserData;
+		if (!vd || !vd->Hwnd)
+		{
+			continue;
+		}
+
+		SWindow& Window = *vd->Hwnd;
+		ImGui_ImplUnreal_WindowState& Pending = vd->PendingState;
+		if (const TOptional<FVector2f> Position = ImGui_ImplUnreal_ConsumeWindowState(Pending.Position, [&Window] { return FVector2f(Window.GetPositionInScreen()); }))
+		{
+			Window.MoveWindowTo(*Position);
+			vd->CachedPosition = *Position;
+		}
+		if (const TOptional<FVector2f> Size = ImGui_ImplUnreal_ConsumeWindowState(Pending.Size, [&Window] { return FVector2f(Window.GetSizeInScreen()); }))
+		{
+			Window.Resize(*Size);
+		}
+		if (const TOptional<FString> Title = ImGui_ImplUnreal_ConsumeWindowState(Pending.Title, [&Window] { return Window.GetTitle().ToString(); }))
+		{
+			Window.SetTitle(FText::FromString(*Title));
+		}
+		if (const TOptional<float> Alpha = ImGui_ImplUnreal_ConsumeWindowState(Pending.Alpha, [&Window] { return Window.GetOpacity(); }))
+		{
+			Window.SetOpacity(*Alpha);
+		}
 	}
 }
 
-static ImGuiStyle GetImGuiStyle()
+// True when nothing drawn in the viewport can be seen: its window or one of its parents is minimized or hidden.
+// @NOTE: Slate doesn't expose whether a window is covered by other windows, occluded viewports are still drawn
+static bool ImGui_ImplUnreal_IsViewportHidden(const ImGuiViewport* Viewport)
 {
-	ImGuiStyle Style = ImGuiStyle();
-	Style.Colors[ImGuiCol_Text] = ImVec4(1.00f, 1.00f, 1.00f, 1.00f);
-	Style.Colors[ImGuiCol_TextDisabled] = ImVec4(0.50f, 0.50f, 0.50f, 1.00f);
-	Style.Colors[ImGuiCol_WindowBg] = ImVec4(0.13f, 0.14f, 0.15f, 1.00f);
-	Style.Colors[ImGuiCol_ChildBg] = ImVec4(0.13f, 0.14f, 0.15f, 1.00f);
-	Style.Colors[ImGuiCol_PopupBg] = ImVec4(0.13f, 0.14f, 0.15f, 1.00f);
-	Style.Colors[ImGuiCol_Border] = ImVec4(0.43f, 0.43f, 0.50f, 0.50f);
-	Style.Colors[ImGuiCol_BorderShadow] = ImVec4(0.00f, 0.00f, 0.00f, 0.00f);
-	Style.Colors[ImGuiCol_FrameBg] = ImVec4(0.25f, 0.25f, 0.25f, 1.00f);
-	Style.Colors[ImGuiCol_FrameBgHovered] = ImVec4(0.38f, 0.38f, 0.38f, 1.00f);
-	Style.Colors[ImGuiCol_FrameBgActive] = ImVec4(0.67f, 0.67f, 0.67f, 0.39f);
-	Style.Colors[ImGuiCol_TitleBg] = ImVec4(0.08f, 0.08f, 0.09f, 1.00f);
-	Style.Colors[ImGuiCol_TitleBgActive] = ImVec4(0.08f, 0.08f, 0.09f, 1.00f);
-	Style.Colors[ImGuiCol_TitleBgCollapsed] = ImVec4(0.00f, 0.00f, 0.00f, 0.51f);
-	Style.Colors[ImGuiCol_MenuBarBg] = ImVec4(0.14f, 0.14f, 0.14f, 1.00f);
-	Style.Colors[ImGuiCol_ScrollbarBg] = ImVec4(0.02f, 0.02f, 0.02f, 0.53f);
-	Style.Colors[ImGuiCol_ScrollbarGrab] = ImVec4(0.31f, 0.31f, 0.31f, 1.00f);
-	Style.Colors[ImGuiCol_ScrollbarGrabHovered] = ImVec4(0.41f, 0.41f, 0.41f, 1.00f);
-	Style.Colors[ImGuiCol_ScrollbarGrabActive] = ImVec4(0.51f, 0.51f, 0.51f, 1.00f);
-	Style.Colors[ImGuiCol_CheckMark] = ImVec4(0.11f, 0.64f, 0.92f, 1.00f);
-	Style.Colors[ImGuiCol_SliderGrab] = ImVec4(0.11f, 0.64f, 0.92f, 1.00f);
-	Style.Colors[ImGuiCol_SliderGrabActive] = ImVec4(0.08f, 0.50f, 0.72f, 1.00f);
+	const ImGui_ImplUnreal_ViewportData* vd = (ImGui_ImplUnreal_ViewportData*)Viewport->PlatformUserData;
+	if (!vd || !vd->Hwnd)
+	{
+		return false;
+	}
+	if (Viewport->Flags & ImGuiViewportFlags_IsMinimized)
+	{
+		return true;
+	}
+
+	for (TSharedPtr<SWindow> Window = vd->Hwnd; Window; Window = Window->GetParentWindow())
+	{
+		if (Window->IsWindowMinimized() || !Window->IsVisible())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// True when a viewport whose draw data was skipped while hidden can be seen again and needs a fresh frame
+static bool ImGui_ImplUnreal_HasRevealedViewport(const ImGuiContext& Context)
+{
+	for (const ImGuiViewport* Viewport : Context.PlatformIO.Viewports)
+	{
+		const ImGui_ImplUnreal_ViewportData* vd = (ImGui_ImplUnreal_ViewportData*)Viewport->PlatformUserData;
+		if (vd && vd->bDrawDataSkipped && !ImGui_ImplUnreal_IsViewportHidden(Viewport))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// NewFramePost hook, hides the windows of hidden viewports for the frame so the code drawing them is skipped
+static void ImGui_ImplUnreal_HideWindowsInHiddenViewports(ImGuiContext* Context, ImGuiContextHook*)
+{
+	if (!GImGuiSkipHiddenViewportWindows)
+	{
+		return;
+	}
+
+	for (ImGuiWindow* Window : Context->Windows)
+	{
+		// @NOTE: ImGui destroys the platform window of a viewport whose owning window is hidden, the owner and dock node
+		// hosts are kept visible. Docked windows are flagged as child windows, other child windows are hidden along with
+		// their parent
+		const bool bChildWindow = (Window->Flags & ImGuiWindowFlags_ChildWindow) && !Window->DockIsActive;
+		const bool bOwnsViewport = Window->Viewport && Window->Viewport->Window == Window;
+		if (!bChildWindow && !bOwnsViewport && !(Window->Flags & ImGuiWindowFlags_DockNodeHost) && Window->Viewport && ImGui_ImplUnreal_IsViewportHidden(Window->Viewport))
+		{
+			// @NOTE: Decremented by Begin before being checked, 2 hides the window for this frame only
+			Window->HiddenFramesCanSkipItems = FMath::Max(Window->HiddenFramesCanSkipItems, 2);
+		}
+	}
+}
+
+static void ImGui_ImplUnreal_RenderWindow(ImGuiViewport* Viewport, void*)
+{
+	ImGui_ImplUnreal_ViewportData* vd = (ImGui_ImplUnreal_ViewportData*)Viewport->PlatformUserData;
+	vd->bDrawDataSkipped = GImGuiSkipHiddenViewports && ImGui_ImplUnreal_IsViewportHidden(Viewport);
+	if (vd->bDrawDataSkipped)
+	{
+		return;
+	}
+
+	if (vd->Canvas)
+	{
+		vd->Canvas->UpdateDrawData(Viewport->DrawData);
+		vd->Canvas->SetDesiredCursor(ImGuiInterop::ImguiToSlateCursor(ImGui::GetMouseCursor()));
+	}
+}
+
+// Converts the draw data of every viewport canvas concurrently, so the canvases only have to submit cached geometry
+// when Slate paints them
+static void ImGui_ImplUnreal_PrepareCanvases(TArray<TPair<SImGuiCanvas*, int32>>& Jobs)
+{
+	if (!GImGuiParallelConversion || !GImGuiReuseUnchangedGeometry)
+	{
+		return;
+	}
+
+	IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_ParallelConversion, "ImGui Parallel Geometry Conversion");
+
+	const ImGuiPlatformIO& PlatformIO = ImGui::GetPlatformIO();
+	for (const ImGuiViewport* Viewport : PlatformIO.Viewports)
+	{
+		const ImGui_ImplUnreal_ViewportData* vd = (ImGui_ImplUnreal_ViewportData*)Viewport->PlatformUserData;
+		if (vd && vd->Canvas && !vd->bDrawDataSkipped)
+		{
+			const int32 NumDrawLists = vd->Canvas->BeginPrepareGeometry();
+			for (int32 DrawListIdx = 0; DrawListIdx < NumDrawLists; ++DrawListIdx)
+			{
+				Jobs.Emplace(vd->Canvas.Get(), DrawListIdx);
+			}
+		}
+	}
+
+	ParallelFor(Jobs.Num(), [&Jobs](int32 JobIndex)
+	{
+		Jobs[JobIndex].Key->PrepareGeometry(Jobs[JobIndex].Value);
+	}, EParallelForFlags::Unbalanced);
+
+	// Don't keep widget pointers around past the conversion
+	Jobs.Reset();
+}
+
+static ImGuiStyle GetImGuiStyle()
+{
+	ImGuiStyle Style = ImGuiStyle();
+	Style.Colors[ImGuiCol_Text] = ImVec4(1.00f, 1.00f, 1.00f, 1.00f);
+	Style.Colors[ImGuiCol_TextDisabled] = ImVec4(0.50f, 0.50f, 0.50f, 1.00f);
+	Style.Colors[ImGuiCol_WindowBg] = ImVec4(0.13f, 0.14f, 0.15f, 1.00f);
+	Style.Colors[ImGuiCol_ChildBg] = ImVec4(0.13f, 0.14f, 0.15f, 1.00f);
+	Style.Colors[ImGuiCol_PopupBg] = ImVec4(0.13f, 0.14f, 0.15f, 1.00f);
+	Style.Colors[ImGuiCol_Border] = ImVec4(0.43f, 0.43f, 0.50f, 0.50f);
+	Style.Colors[ImGuiCol_BorderShadow] = ImVec4(0.00f, 0.00f, 0.00f, 0.00f);
+	Style.Colors[ImGuiCol_FrameBg] = ImVec4(0.25f, 0.25f, 0.25f, 1.00f);
+	Style.Colors[ImGuiCol_FrameBgHovered] = ImVec4(0.38f, 0.38f, 0.38f, 1.00f);
+	Style.Colors[ImGuiCol_FrameBgActive] = ImVec4(0.67f, 0.67f, 0.67f, 0.39f);
+	Style.Colors[ImGuiCol_TitleBg] = ImVec4(0.08f, 0.08f, 0.09f, 1.00f);
+	Style.Colors[ImGuiCol_TitleBgActive] = ImVec4(0.08f, 0.08f, 0.09f, 1.00f);
+	Style.Colors[ImGuiCol_TitleBgCollapsed] = ImVec4(0.00f, 0.00f, 0.00f, 0.51f);
+	Style.Colors[ImGuiCol_MenuBarBg] = ImVec4(0.14f, 0.14f, 0.14f, 1.00f);
+	Style.Colors[ImGuiCol_ScrollbarBg] = ImVec4(0.02f, 0.02f, 0.02f, 0.53f);
+	Style.Colors[ImGuiCol_ScrollbarGrab] = ImVec4(0.31f, 0.31f, 0.31f, 1.00f);
+	Style.Colors[ImGuiCol_ScrollbarGrabHovered] = ImVec4(0.41f, 0.41f, 0.41f, 1.00f);
+	Style.Colors[ImGuiCol_ScrollbarGrabActive] = ImVec4(0.51f, 0.51f, 0.51f, 1.00f);
+	Style.Colors[ImGuiCol_CheckMark] = ImVec4(0.11f, 0.64f, 0.92f, 1.00f);
+	Style.Colors[ImGuiCol_SliderGrab] = ImVec4(0.11f, 0.64f, 0.92f, 1.00f);
+	Style.Colors[ImGuiCol_SliderGrabActive] = ImVec4(0.08f, 0.50f, 0.72f, 1.00f);
 	Style.Colors[ImGuiCol_Button] = ImVec4(0.25f, 0.25f, 0.25f, 1.00f);
 	Style.Colors[ImGuiCol_ButtonHovered] = ImVec4(0.38f, 0.38f, 0.38f, 1.00f);
 	Style.Colors[ImGuiCol_ButtonActive] = ImVec4(0.67f, 0.67f, 0.67f, 0.39f);
@@ -818,21 +2398,259 @@ static ImGuiStyle GetImGuiStyle()
 	return Style;
 }
 
-void UImGuiSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+// Builds the frames of a context dedicated to registered panels on its own thread, see ImGui.Thread.Enable. The game
+// thread only hands the last completed frame to the canvas, takes the panel snapshots and kicks the next frame.
+// @NOTE: The current ImGui context is a plain global, so the game thread hands it over with the frame: the ImGui thread
+// makes its context current while building and restores the previous one before completing. A frame is kicked at the
+// end of the Slate pre tick and waited for at the Slate post tick, it is only built while Slate ticks widgets and
+// paints, never while input, worlds, tickers, console commands or tests can use ImGui on the game thread
+class FImGuiThread : public FRunnable
 {
-	Super::Initialize(Collection);
+public:
+	explicit FImGuiThread(ImFontAtlas* SharedFontAtlas);
+	virtual ~FImGuiThread() override;
+
+	// Game thread
+	void Tick(const TArray<TSharedRef<FImGuiPanel, ESPMode::ThreadSafe>>& Panels, float DeltaTime);
+	// Game thread, blocks until the frame in flight is built and the current context is the game thread's one again
+	void WaitForFrame();
+
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	void BuildFrame();
+
+	ImGuiContext* Context = nullptr;
+	ImPlotContext* PlotContext = nullptr;
+	TAnsiStringBuilder<512> IniFileName;
+
+	TSharedPtr<FImGuiInputQueue> InputQueue;
+	TSharedPtr<SWindow> Window;
+	TSharedPtr<SImGuiCanvas> Canvas;
+
+	// Written by the game thread before kicking a frame, read by the ImGui thread while building it
+	TArray<TSharedRef<FImGuiPanel, ESPMode::ThreadSafe>> FramePanels;
+	float FrameDeltaTime = 0.0f;
+	FVector2f FrameDisplaySize = FVector2f::ZeroVector;
+
+	float PendingDeltaTime = 0.0f;
+	bool bHasCompletedFrame = false;
+	bool bFrameInFlight = false; // Game thread
+	std::atomic<bool> bStopping = false;
+	FEvent* FrameRequested = nullptr;
+	FEvent* FrameCompleted = nullptr;
+	FRunnableThread* Thread = nullptr;
+};
+
+FImGuiThread::FImGuiThread(ImFontAtlas* SharedFontAtlas)
+{
+	// @NOTE: Shares the font atlas (and its texture) of the other contexts. The game contexts stay between NewFrame and
+	// Render across ticks, the atlas Locked flag this context's NewFrame and EndFrame toggle is restored after each frame
+	Context = ImGui::CreateContext(SharedFontAtlas);
+	PlotContext = ImPlot::CreateContext();
+	{
+		ImGuiContext* PreviousContext = ImGui::GetCurrentContext();
+		ImGui::SetCurrentContext(Context);
+
+		ImGuiIO& IO = ImGui::GetIO();
+		IO.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
+		IO.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+		IO.BackendPlatformName = "Unreal (ImGui thread)";
+		IO.BackendFlags |= ImGuiBackendFlags_HasMouseCursors;
+		IO.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+
+		IniFileName.Append(*FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ImGui"), TEXT("ImGui_Thread.ini")));
+		IO.IniFilename = IniFileName.ToString();
+		ImGui::GetStyle() = GetImGuiStyle();
+
+		ImGui::SetCurrentContext(PreviousContext);
+	}
+
+	InputQueue = MakeShared<FImGuiInputQueue>();
+	SAssignNew(Window, SWindow)
+		.Title(INVTEXT("ImGui Panels"))
+		.ClientSize({800.0f, 600.0f})
+		.Content()
+		[
+			MakeCanvasHost(SAssignNew(Canvas, SImGuiCanvas)
+				.Identifier("Thread")
+				.ViewportID(IMGUI_VIEWPORT_DEFAULT_ID)
+				.Context(Context)
+				.InputQueue(InputQueue))
+		];
+	FSlateApplication::Get().AddWindow(Window.ToSharedRef());
+
+	FrameRequested = FPlatformProcess::GetSynchEventFromPool();
+	FrameCompleted = FPlatformProcess::GetSynchEventFromPool();
+	Thread = FRunnableThread::Create(this, TEXT("ImGuiThread"), 0, TPri_BelowNormal);
+}
+
+FImGuiThread::~FImGuiThread()
+{
+	WaitForFrame();
+	Stop();
+	Thread->WaitForCompletion();
+	delete Thread;
+	FPlatformProcess::ReturnSynchEventToPool(FrameRequested);
+	FPlatformProcess::ReturnSynchEventToPool(FrameCompleted);
+
+	Canvas->ClearContext();
+	if (Window)
+	{
+		Window->RequestDestroyWindow();
+	}
+
+	ImPlot::DestroyContext(PlotContext);
+	ImGui::DestroyContext(Context);
+}
+
+void FImGuiThread::WaitForFrame()
+{
+	if (bFrameInFlight)
+	{
+		IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_ThreadWait, "ImGui Thread Wait");
+		FrameCompleted->Wait();
+		bFrameInFlight = false;
+	}
+}
+
+void FImGuiThread::Tick(const TArray<TSharedRef<FImGuiPanel, ESPMode::ThreadSafe>>& Panels, float DeltaTime)
+{
+	PendingDeltaTime += DeltaTime;
+	WaitForFrame();
+
+	if (bHasCompletedFrame)
+	{
+		// @NOTE: The ImGui thread is idle until the next frame is kicked, so its draw data can be taken from here
+		Canvas->UpdateDrawData(Context->Viewports[0]->DrawData);
+		Canvas->SetDesiredCursor(ImGuiInterop::ImguiToSlateCursor(Context->MouseCursor));
+	}
+
+	for (const TSharedRef<FImGuiPanel, ESPMode::ThreadSafe>& Panel : Panels)
+	{
+		if (Panel->Snapshot)
+		{
+			Panel->Snapshot();
+		}
+	}
+
+	FramePanels = Panels;
+	FrameDeltaTime = PendingDeltaTime;
+	FrameDisplaySize = Window && Window->IsVisible() ? Canvas->GetCachedGeometry().GetAbsoluteSize() : FVector2f::ZeroVector;
+	PendingDeltaTime = 0.0f;
+
+	Canvas->FlushPendingInput();
+	const FModifierKeysState ModifierKeys = FSlateApplication::Get().GetModifierKeys();
+	InputQueue->Push([ModifierKeys](ImGuiIO& IO)
+	{
+		IO.AddKeyEvent(ImGuiMod_Ctrl, ModifierKeys.IsControlDown());
+		IO.AddKeyEvent(ImGuiMod_Shift, ModifierKeys.IsShiftDown());
+		IO.AddKeyEvent(ImGuiMod_Alt, ModifierKeys.IsAltDown());
+		IO.AddKeyEvent(ImGuiMod_Super, ModifierKeys.IsCommandDown());
+	});
+
+	bFrameInFlight = true;
+	FrameRequested->Trigger();
+}
+
+uint32 FImGuiThread::Run()
+{
+	while (!bStopping)
+	{
+		FrameRequested->Wait();
+		if (bStopping)
+		{
+			break;
+		}
+
+		BuildFrame();
+		bHasCompletedFrame = true;
+		FrameCompleted->Trigger();
+	}
+	return 0;
+}
 
-	check(!ImGui::GetCurrentContext()); // init imgui only once
-	ImGui::CreateContext();
+void FImGuiThread::Stop()
+{
+	bStopping = true;
+	FrameRequested->Trigger();
+}
 
-	ImPlot::CreateContext();
+void FImGuiThread::BuildFrame()
+{
+	ImGuiContext* PreviousContext = ImGui::GetCurrentContext();
+	ImPlotContext* PreviousPlotContext = ImPlot::GetCurrentContext();
+	ImGui::SetCurrentContext(Context);
+	ImPlot::SetCurrentContext(PlotContext);
 
 	ImGuiIO& IO = ImGui::GetIO();
+	const bool bFontAtlasLocked = IO.Fonts->Locked;
+	IO.DeltaTime = FMath::Max(FrameDeltaTime, UE_SMALL_NUMBER);
+	IO.DisplaySize = ImVec2{FrameDisplaySize.X, FrameDisplaySize.Y};
+	InputQueue->Apply(IO);
+	INC_DWORD_STAT_BY(STAT_ImGui_InputEventsQueued, Context->InputEventsQueue.Size);
+
+	{
+		IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_NewFrame, "ImGui NewFrame");
+		ImGui::NewFrame();
+	}
+	{
+		IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_Panels, "ImGui Registered Panels");
+		for (const TSharedRef<FImGuiPanel, ESPMode::ThreadSafe>& Panel : FramePanels)
+		{
+			if (Panel->Draw)
+			{
+				Panel->Draw();
+			}
+		}
+	}
+	{
+		IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_Render, "ImGui Render");
+		ImGui::Render();
+	}
+	FramePanels.Reset();
+	IO.Fonts->Locked = bFontAtlasLocked;
+
+	ImGui::SetCurrentContext(PreviousContext);
+	ImPlot::SetCurrentContext(PreviousPlotContext);
+}
+
+FImGuiContextScope::FImGuiContextScope(const FImGuiViewportContext& ViewportContext)
+	: PreviousContext(ImGui::GetCurrentContext())
+	, PreviousPlotContext(ImPlot::GetCurrentContext())
+{
+	ImGui::SetCurrentContext(ViewportContext.Context);
+	ImPlot::SetCurrentContext(ViewportContext.PlotContext);
+}
+
+FImGuiContextScope::FImGuiContextScope(const UWorld* World)
+	: FImGuiContextScope(GEngine->GetEngineSubsystem<UImGuiSubsystem>()->GetContextForWorld(World))
+{
+}
+
+FImGuiContextScope::~FImGuiContextScope()
+{
+	ImGui::SetCurrentContext(PreviousContext);
+	ImPlot::SetCurrentContext(PreviousPlotContext);
+}
+
+void UImGuiSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+#if WITH_IMGUI_BENCHMARK
+	// @NOTE: Before any allocation of ImGui, ImGui.Benchmark counts the allocations of its own context through it
+	ImGuiBenchmarkScenes::InstallAllocationCounter();
+#endif
+
+	check(!FontAtlas); // init imgui only once
+	FontAtlas = IM_NEW(ImFontAtlas)();
 
 	unsigned char* ImPixels;
 	int FontAtlasWidth, FontAtlasHeight, FontAtlasBPP;
 	// Setup font texture
-	IO.Fonts->GetTexDataAsRGBA32(&ImPixels, &FontAtlasWidth, &FontAtlasHeight, &FontAtlasBPP);
+	FontAtlas->GetTexDataAsRGBA32(&ImPixels, &FontAtlasWidth, &FontAtlasHeight, &FontAtlasBPP);
 	check(FontAtlasBPP == 4);
 
 	FontTexture = UTexture2D::CreateTransient(FontAtlasWidth, FontAtlasHeight, PF_R8G8B8A8, "ImGuiDefaultFontTexture");
@@ -852,7 +2670,31 @@ void UImGuiSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 		                                                static_cast<float>(FontAtlasWidth),
 		                                                static_cast<float>(FontAtlasHeight)
 	                                                });
-	IO.Fonts->SetTexID((ImTextureID)FontTextureBrush.Get());
+	FontAtlas->SetTexID((ImTextureID)FontTextureBrush.Get());
+
+	ImGui_ImplUnreal_InitMonitors();
+
+	// @NOTE: The default context stays current outside of world ticks, so code that isn't aware of game viewports keeps working
+	const FImGuiViewportContext& DefaultContext = CreateContext(nullptr, TEXT("ImGui.ini"));
+	ImGui::SetCurrentContext(DefaultContext.Context);
+	ImPlot::SetCurrentContext(DefaultContext.PlotContext);
+
+	FSlateApplication::Get().OnPreTick().AddUObject(this, &UImGuiSubsystem::TickImGui);
+	FSlateApplication::Get().OnPostTick().AddUObject(this, &UImGuiSubsystem::PostTickImGui);
+	FWorldDelegates::OnWorldInitializedActors.AddUObject(this, &UImGuiSubsystem::WorldInitializedActors);
+	FWorldDelegates::OnWorldTickStart.AddUObject(this, &UImGuiSubsystem::WorldTickStart);
+	FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UImGuiSubsystem::WorldPostActorTick);
+}
+
+FImGuiViewportContext& UImGuiSubsystem::CreateContext(UGameViewportClient* GameViewport, const FString& IniName)
+{
+	FImGuiViewportContext& ViewportContext = *Contexts.Add_GetRef(MakeUnique<FImGuiViewportContext>());
+	ViewportContext.GameViewport = GameViewport;
+	ViewportContext.Context = ImGui::CreateContext(FontAtlas);
+	ViewportContext.PlotContext = ImPlot::CreateContext();
+
+	FImGuiContextScope ContextScope(ViewportContext);
+	ImGuiIO& IO = ImGui::GetIO();
 
 	IO.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
 	IO.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;
@@ -864,8 +2706,8 @@ void UImGuiSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 	// Make sure that directory is created.
 	IPlatformFile::GetPlatformPhysical().CreateDirectory(*Directory);
 
-	IniFileName.Append(*FPaths::Combine(Directory, "ImGui.ini"));
-	IO.IniFilename = IniFileName.ToString();
+	ViewportContext.IniFileName.Append(*FPaths::Combine(Directory, IniName));
+	IO.IniFilename = ViewportContext.IniFileName.ToString();
 
 	ImGui::GetStyle() = GetImGuiStyle();
 
@@ -887,7 +2729,7 @@ void UImGuiSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 	// Platform setup
 	ImGuiPlatformIO& PlatformIO = ImGui::GetPlatformIO();
 
-	ImGui_ImplUnreal_UpdateMonitors();
+	ImGui_ImplUnreal_UpdateMonitors(ViewportContext.MonitorsRevision);
 
 	PlatformIO.Platform_CreateWindow = ImGui_ImplUnreal_CreateWindow;
 	PlatformIO.Platform_DestroyWindow = ImGui_ImplUnreal_DestroyWindow;
@@ -907,15 +2749,97 @@ void UImGuiSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 
 	PlatformIO.Renderer_RenderWindow = ImGui_ImplUnreal_RenderWindow;
 
+	ImGuiContextHook HideWindowsHook;
+	HideWindowsHook.Type = ImGuiContextHookType_NewFramePost;
+	HideWindowsHook.Callback = ImGui_ImplUnreal_HideWindowsInHiddenViewports;
+	ImGui::AddContextHook(ViewportContext.Context, &HideWindowsHook);
+
 	ImGuiViewport* MainViewport = ImGui::GetMainViewport();
 	ImGui_ImplUnreal_ViewportData* vd = IM_NEW(ImGui_ImplUnreal_ViewportData)();
 	vd->bHwndOwned = false;
 	MainViewport->PlatformUserData = vd;
 
-	FSlateApplication::Get().OnPreTick().AddUObject(this, &UImGuiSubsystem::TickImGui);
-	FWorldDelegates::OnWorldInitializedActors.AddUObject(this, &UImGuiSubsystem::WorldInitializedActors);
+	return ViewportContext;
+}
+
+void UImGuiSubsystem::DestroyContext(FImGuiViewportContext& ViewportContext)
+{
+	// @NOTE: Destroying the context destroys its platform windows through ImGui_ImplUnreal_DestroyWindow, which also
+	// detaches the main viewport canvas from its game viewport
+	ImPlot::DestroyContext(ViewportContext.PlotContext);
+	ImGui::DestroyContext(ViewportContext.Context);
+	ViewportContext.PlotContext = nullptr;
+	ViewportContext.Context = nullptr;
+}
+
+void UImGuiSubsystem::SyncGameViewportContexts()
+{
+	// Drop the contexts of game viewports that went away, or all of them when they're disabled
+	for (int32 ContextIdx = Contexts.Num() - 1; ContextIdx > 0; --ContextIdx)
+	{
+		const UGameViewportClient* GameViewport = Contexts[ContextIdx]->GameViewport.Get();
+		const FWorldContext* WorldContext = GameViewport ? GEngine->GetWorldContextFromGameViewport(GameViewport) : nullptr;
+		if (!GImGuiPerGameViewportContexts || !WorldContext)
+		{
+			DestroyContext(*Contexts[ContextIdx]);
+			Contexts.RemoveAt(ContextIdx);
+		}
+	}
+
+	if (!GImGuiPerGameViewportContexts)
+	{
+		return;
+	}
+
+	for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+	{
+		UGameViewportClient* GameViewport = WorldContext.GameViewport;
+		if (GameViewport && !Contexts.ContainsByPredicate([GameViewport](const TUniquePtr<FImGuiViewportContext>& ViewportContext)
+		{
+			return ViewportContext->GameViewport == GameViewport;
+		}))
+		{
+			const FString IniName = WorldContext.WorldType == EWorldType::PIE
+				                        ? FString::Printf(TEXT("ImGui_PIE%d.ini"), WorldContext.PIEInstance)
+				                        : FString(TEXT("ImGui_Game.ini"));
+			CreateContext(GameViewport, IniName);
+		}
+	}
+}
+
+FImGuiViewportContext* UImGuiSubsystem::FindContextForWorld(const UWorld* World) const
+{
+	const FWorldContext* WorldContext = GImGuiPerGameViewportContexts && World ? GEngine->GetWorldContextFromWorld(World) : nullptr;
+	if (!WorldContext || !WorldContext->GameViewport)
+	{
+		return Contexts[0].Get();
+	}
+
+	for (const TUniquePtr<FImGuiViewportContext>& ViewportContext : Contexts)
+	{
+		if (ViewportContext->GameViewport == WorldContext->GameViewport)
+		{
+			return ViewportContext.Get();
+		}
+	}
+	return nullptr;
+}
+
+const FImGuiViewportContext& UImGuiSubsystem::GetContextForWorld(const UWorld* World) const
+{
+	const FImGuiViewportContext* ViewportContext = FindContextForWorld(World);
+	return ViewportContext ? *ViewportContext : *Contexts[0];
+}
+
+void UImGuiSubsystem::RegisterPanel(FName Name, FImGuiPanel Panel)
+{
+	Panels.Add(Name, MakeShared<FImGuiPanel, ESPMode::ThreadSafe>(MoveTemp(Panel)));
 }
 
+void UImGuiSubsystem::UnregisterPanel(FName Name)
+{
+	Panels.Remove(Name);
+}
 
 void UImGuiSubsystem::WindowTest()
 {
@@ -927,12 +2851,60 @@ void UImGuiSubsystem::WindowTest()
 		              Content()[SNew(SImGuiCanvas).Identifier("Test 2")]);
 }
 
+void UImGuiSubsystem::RequestRedraw()
+{
+	UImGuiSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UImGuiSubsystem>() : nullptr;
+	if (!Subsystem)
+	{
+		return;
+	}
+
+	for (const TUniquePtr<FImGuiViewportContext>& ViewportContext : Subsystem->Contexts)
+	{
+		if (ViewportContext->Context == ImGui::GetCurrentContext())
+		{
+			ViewportContext->LazyFramesToRender = FMath::Max(ViewportContext->LazyFramesToRender, 1);
+		}
+	}
+}
+
+void UImGuiSubsystem::BeginMissingFrames()
+{
+	SyncGameViewportContexts();
+	for (const TUniquePtr<FImGuiViewportContext>& ViewportContext : Contexts)
+	{
+		if (!ViewportContext->bInImGuiFrame)
+		{
+			FImGuiContextScope ContextScope(*ViewportContext);
+			TickContext(*ViewportContext, 0.016f);
+		}
+	}
+}
+
 void UImGuiSubsystem::WorldInitializedActors(const FActorsInitializedParams& ActorsInitializedParams)
 {
-	if (!bInImGuiFrame) // @NOTE: This is to ensure we have an imgui frame started when the world starts, might not be necessary anymore
+	// @NOTE: This is to ensure we have an imgui frame started when the world starts, might not be necessary anymore
+	BeginMissingFrames();
+}
+
+void UImGuiSubsystem::WorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	// Code ticking with the world draws in the context of its game viewport
+	const FImGuiViewportContext* ViewportContext = FindContextForWorld(World);
+	if (!ViewportContext)
 	{
-		TickImGui(0.016f);
+		BeginMissingFrames();
+		ViewportContext = &GetContextForWorld(World);
 	}
+
+	WorldTickContextScope.Reset();
+	WorldTickContextScope.Emplace(*ViewportContext);
+}
+
+void UImGuiSubsystem::WorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	// Back to the context that was current before the world ticked, the default one outside of world ticks
+	WorldTickContextScope.Reset();
 }
 
 static TSharedPtr<SWindow> FindWindow(const TSharedPtr<SImGuiCanvas>& Canvas)
@@ -950,54 +2922,599 @@ static TSharedPtr<SWindow> FindWindow(const TSharedPtr<SImGuiCanvas>& Canvas)
 	return nullptr;
 }
 
-void UImGuiSubsystem::TickImGui(float DeltaTime)
+bool UImGuiSubsystem::ShouldRenderFrame(FImGuiViewportContext& ViewportContext) const
 {
-	const ImGuiViewport* MainViewport = ImGui::GetMainViewport();
-	if (bInImGuiFrame)
+	const double Now = FPlatformTime::Seconds();
+	const bool bRateLimited = GImGuiMaxUpdateRate > 0.0f && Now - ViewportContext.LastRenderTime < 1.0 / GImGuiMaxUpdateRate;
+	if (!GImGuiLazyFrames)
 	{
-		// UE_LOG(LogTemp, Warning, TEXT("=== ImGui Render ==="));
-		ImGui::Render();
-
-		ImGui_ImplUnreal_RenderWindow(ImGui::GetMainViewport(), nullptr);
-		ImGui::UpdatePlatformWindows();
-		ImGui::RenderPlatformWindowsDefault();
-		bInImGuiFrame = false;
+		return !bRateLimited;
 	}
 
-	if (MainViewport->PlatformUserData && !GEngine->GameViewport)
-	// Cleanup MainViewport data if the game viewport is suddenly invalid
+	const ImGuiContext& Context = *ViewportContext.Context;
+	const ImGuiIO& IO = Context.IO;
+	const bool bActive = Context.InputEventsTrail.Size > 0
+		|| Context.InputEventsQueue.Size > 0
+		|| Context.ActiveId != 0
+		|| Context.DragDropActive
+		|| Context.NavWindowingTarget != nullptr
+		|| (Context.DimBgRatio > 0.0f && Context.DimBgRatio < 1.0f)
+		|| IO.WantTextInput // Blinking text cursor
+		|| (Context.HoveredId != 0 && Context.HoveredIdTimer < Context.Style.HoverDelayNormal + Context.Style.HoverStationaryDelay) // Pending tooltip
+		|| Context.Viewports.Size != ViewportContext.LastRenderedViewportCount
+		|| ImGui_ImplUnreal_HasRevealedViewport(Context)
+		|| FVector2f{IO.DisplaySize.x, IO.DisplaySize.y} != ViewportContext.LastRenderedDisplaySize;
+	if (bActive)
 	{
-		ImGui_ImplUnreal_ViewportData* vd = (ImGui_ImplUnreal_ViewportData*)MainViewport->PlatformUserData;
-		vd->Canvas = nullptr;
-		vd->Hwnd = nullptr;
+		ViewportContext.LazyFramesToRender = FMath::Max(ViewportContext.LazyFramesToRender, 1 + LazyFrameSettleCount);
 	}
 
-	if (ImGui_ImplUnreal_ViewportData* vd = (ImGui_ImplUnreal_ViewportData*)MainViewport->PlatformUserData)
+	// @NOTE: Activity seen while rate limited stays pending until the next frame we're allowed to render
+	if (bRateLimited)
 	{
-		if (GEngine->GameViewport && !vd->Canvas) // Create the canvas if the GameViewport is valid
-		{
-			TSharedPtr<SImGuiCanvas> ImGuiCanvas;
-			GEngine->GameViewport->AddViewportWidgetContent(SAssignNew(ImGuiCanvas, SImGuiCanvas)
-			                                                .Identifier("Main")
-			                                                .ViewportID(MainViewport->ID), 1000);
-
-			// FSlateApplication::Get().
-			vd->Hwnd = FindWindow(ImGuiCanvas);
-			vd->bHwndOwned = false;
-			vd->Canvas = ImGuiCanvas;
-		}
+		return false;
 	}
 
-	if (!bInImGuiFrame)
+	if (ViewportContext.LazyFramesToRender > 0)
 	{
-		ImGuiIO& IO = ImGui::GetIO();
+		ViewportContext.LazyFramesToRender--;
+		return true;
+	}
+
+	return GImGuiLazyMinRefreshRate > 0.0f && Now - ViewportContext.LastRenderTime >= 1.0 / GImGuiLazyMinRefreshRate;
+}
+
+static FString GetContextLabel(const FImGuiViewportContext& ViewportContext)
+{
+	const UGameViewportClient* GameViewport = ViewportContext.GameViewport.Get();
+	const FWorldContext* WorldContext = GameViewport ? GEngine->GetWorldContextFromGameViewport(GameViewport) : nullptr;
+	return WorldContext ? WorldContext->ContextHandle.ToString() : TEXT("Default");
+}
+
+// Splits Seconds between the top level windows begun since the window with BeginOrder FirstBeginOrder
+static void AttributeBuildTime(FImGuiViewportContext& ViewportContext, int32 FirstBeginOrder, double Seconds)
+{
+	const ImGuiContext& g = *ViewportContext.Context;
+	TArray<ImGuiWindow*, TInlineAllocator<8>> BegunWindows;
+	for (ImGuiWindow* Window : g.Windows)
+	{
+		if (Window->Active && Window->RootWindow == Window && Window->BeginOrderWithinContext >= FirstBeginOrder)
+		{
+			BegunWindows.Add(Window);
+		}
+	}
+
+	for (ImGuiWindow* Window : BegunWindows)
+	{
+		ViewportContext.WindowCosts.FindOrAdd(Window->ID).PendingBuildTime += Seconds / BegunWindows.Num();
+	}
+}
+
+// Walks the draw list of every window that was added to the draw data
+static void CollectWindowCosts(FImGuiViewportContext& ViewportContext)
+{
+	for (TPair<uint32, FImGuiWindowCost>& Cost : ViewportContext.WindowCosts)
+	{
+		Cost.Value.Vertices = 0;
+		Cost.Value.Indices = 0;
+		Cost.Value.DrawCmds = 0;
+		Cost.Value.BuildTime = Cost.Value.PendingBuildTime;
+		Cost.Value.PendingBuildTime = 0.0;
+	}
+
+	const ImGuiContext& g = *ViewportContext.Context;
+	for (ImGuiWindow* Window : g.Windows)
+	{
+		// Same filter as AddWindowToDrawData, child windows count towards their top level window
+		if (!Window->Active || Window->Hidden)
+		{
+			continue;
+		}
+
+		FImGuiWindowCost& Cost = ViewportContext.WindowCosts.FindOrAdd(Window->RootWindow->ID);
+		if (Cost.Name.IsEmpty())
+		{
+			Cost.Name = UTF8_TO_TCHAR(Window->RootWindow->Name);
+		}
+		Cost.Vertices += Window->DrawList->VtxBuffer.Size;
+		Cost.Indices += Window->DrawList->IdxBuffer.Size;
+		Cost.DrawCmds += Window->DrawList->CmdBuffer.Size;
+		Cost.LastFrame = GFrameCounter;
+	}
+
+	for (auto It = ViewportContext.WindowCosts.CreateIterator(); It; ++It)
+	{
+		FImGuiWindowCost& Cost = It.Value();
+		if (GFrameCounter - Cost.LastFrame > FImGuiWindowCost::HistorySize)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		if (Cost.VertexHistory.Num() < FImGuiWindowCost::HistorySize)
+		{
+			Cost.VertexHistory.Add(Cost.Vertices);
+			Cost.BuildTimeHistory.Add(Cost.BuildTime * 1000.0);
+		}
+		else
+		{
+			Cost.VertexHistory[Cost.HistoryOffset] = Cost.Vertices;
+			Cost.BuildTimeHistory[Cost.HistoryOffset] = Cost.BuildTime * 1000.0;
+			Cost.HistoryOffset = (Cost.HistoryOffset + 1) % FImGuiWindowCost::HistorySize;
+		}
+	}
+}
+
+void UImGuiSubsystem::DrawProfiler()
+{
+	bool bOpen = true;
+	if (ImGui::Begin("ImGui Profiler", &bOpen))
+	{
+		// @NOTE: Contexts come and go with game viewports, the selection falls back to the default context once its
+		// context is destroyed
+		const TUniquePtr<FImGuiViewportContext>* SelectedContext = Contexts.FindByPredicate([this](const TUniquePtr<FImGuiViewportContext>& ViewportContext)
+		{
+			return ViewportContext->Context == ProfilerContext;
+		});
+		const FImGuiViewportContext& ViewportContext = SelectedContext ? **SelectedContext : *Contexts[0];
+		if (ImGui::BeginCombo("Context", TCHAR_TO_UTF8(*GetContextLabel(ViewportContext))))
+		{
+			for (const TUniquePtr<FImGuiViewportContext>& Candidate : Contexts)
+			{
+				if (ImGui::Selectable(TCHAR_TO_UTF8(*GetContextLabel(*Candidate)), Candidate.Get() == &ViewportContext))
+				{
+					ProfilerContext = Candidate->Context;
+				}
+			}
+			ImGui::EndCombo();
+		}
+
+		TArray<TPair<uint32, const FImGuiWindowCost*>> Rows;
+		for (const TPair<uint32, FImGuiWindowCost>& Cost : ViewportContext.WindowCosts)
+		{
+			Rows.Emplace(Cost.Key, &Cost.Value);
+		}
+
+		constexpr ImGuiTableFlags TableFlags = ImGuiTableFlags_Sortable | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg
+			| ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY;
+		if (ImGui::BeginTable("Windows", 5, TableFlags, {0.0f, ImGui::GetContentRegionAvail().y * 0.5f}))
+		{
+			ImGui::TableSetupScrollFreeze(0, 1);
+			ImGui::TableSetupColumn("Window", ImGuiTableColumnFlags_WidthStretch);
+			ImGui::TableSetupColumn("Vertices", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending);
+			ImGui::TableSetupColumn("Indices", ImGuiTableColumnFlags_PreferSortDescending);
+			ImGui::TableSetupColumn("Draw Cmds", ImGuiTableColumnFlags_PreferSortDescending);
+			ImGui::TableSetupColumn("Build (ms)", ImGuiTableColumnFlags_PreferSortDescending);
+			ImGui::TableHeadersRow();
+
+			if (const ImGuiTableSortSpecs* SortSpecs = ImGui::TableGetSortSpecs(); SortSpecs && SortSpecs->SpecsCount > 0)
+			{
+				const ImGuiTableColumnSortSpecs& Spec = SortSpecs->Specs[0];
+				Rows.Sort([&Spec](const TPair<uint32, const FImGuiWindowCost*>& A, const TPair<uint32, const FImGuiWindowCost*>& B)
+				{
+					const FImGuiWindowCost& Lhs = Spec.SortDirection == ImGuiSortDirection_Ascending ? *A.Value : *B.Value;
+					const FImGuiWindowCost& Rhs = Spec.SortDirection == ImGuiSortDirection_Ascending ? *B.Value : *A.Value;
+					switch (Spec.ColumnIndex)
+					{
+					case 0: return Lhs.Name < Rhs.Name;
+					case 1: return Lhs.Vertices < Rhs.Vertices;
+					case 2: return Lhs.Indices < Rhs.Indices;
+					case 3: return Lhs.DrawCmds < Rhs.DrawCmds;
+					default: return Lhs.BuildTime < Rhs.BuildTime;
+					}
+				});
+			}
+
+			for (const TPair<uint32, const FImGuiWindowCost*>& Row : Rows)
+			{
+				const FImGuiWindowCost& Cost = *Row.Value;
+				ImGui::PushID(Row.Key);
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				if (ImGui::Selectable(TCHAR_TO_UTF8(*Cost.Name), Row.Key == ProfilerSelectedWindow, ImGuiSelectableFlags_SpanAllColumns))
+				{
+					ProfilerSelectedWindow = Row.Key;
+				}
+				ImGui::TableNextColumn();
+				ImGui::Text("%d", Cost.Vertices);
+				ImGui::TableNextColumn();
+				ImGui::Text("%d", Cost.Indices);
+				ImGui::TableNextColumn();
+				ImGui::Text("%d", Cost.DrawCmds);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", Cost.BuildTime * 1000.0);
+				ImGui::PopID();
+			}
+			ImGui::EndTable();
+		}
+
+		if (const FImGuiWindowCost* Selected = ViewportContext.WindowCosts.Find(ProfilerSelectedWindow))
+		{
+			if (ImPlot::BeginPlot("History", {-1.0f, -1.0f}))
+			{
+				ImPlot::SetupAxes("Frame", "Vertices", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+				ImPlot::SetupAxis(ImAxis_Y2, "Build (ms)", ImPlotAxisFlags_AutoFit | ImPlotAxisFlags_Opposite);
+				ImPlot::PlotLine("Vertices", Selected->VertexHistory.GetData(), Selected->VertexHistory.Num(), 1.0, 0.0, 0, Selected->HistoryOffset);
+				ImPlot::SetAxes(ImAxis_X1, ImAxis_Y2);
+				ImPlot::PlotLine("Build (ms)", Selected->BuildTimeHistory.GetData(), Selected->BuildTimeHistory.Num(), 1.0, 0.0, 0, Selected->HistoryOffset);
+				ImPlot::EndPlot();
+			}
+		}
+		else
+		{
+			ImGui::TextDisabled("Select a window to plot its history");
+		}
+	}
+	ImGui::End();
+
+	if (!bOpen)
+	{
+		GImGuiProfilerEnable = 0;
+	}
+}
+
+// Name the font atlas is written under in .imdraw files, other textures use their object path
+static const TCHAR* CapturedFontTextureName = TEXT("<ImGuiFont>");
+
+// Captured draw data fed to canvases of its own, see ImGui.Replay
+struct FImGuiDrawReplay
+{
+	FImGuiDrawCaptureReader Reader;
+	TArray<ImTextureID> Textures; // Indexed like the texture names of the capture
+	TArray<TUniquePtr<FSlateBrush>> Brushes;
+	TArray<TStrongObjectPtr<UTexture>> LoadedTextures;
+
+	TArray<FImGuiCapturedViewport> Viewports;
+	TMap<ImGuiID, TSharedPtr<SImGuiCanvas>> Canvases;
+	TArray<TSharedRef<SWindow>> Windows;
+	int32 Frame = 0;
+	int32 LoopsLeft = 0;
+};
+
+void UImGuiSubsystem::StartDrawCapture(int32 Frames, const FString& FilePath)
+{
+	DrawCapture = MakeShared<FImGuiDrawCaptureWriter>();
+	DrawCaptureFramesLeft = FMath::Max(Frames, 1);
+	DrawCapturePath = FilePath;
+}
+
+void UImGuiSubsystem::CaptureDrawData()
+{
+	DrawCapture->AddFrame(ImGui::GetPlatformIO().Viewports, [this](ImTextureID TextureId)
+	{
+		const FSlateBrush* Brush = (const FSlateBrush*)TextureId;
+		if (!Brush || Brush == FontTextureBrush.Get())
+		{
+			return FString(Brush ? CapturedFontTextureName : TEXT(""));
+		}
+		const UObject* Resource = Brush->GetResourceObject();
+		return Resource ? Resource->GetPathName() : Brush->GetResourceName().ToString();
+	});
+
+	if (--DrawCaptureFramesLeft > 0)
+	{
+		return;
+	}
+
+	if (DrawCapture->Save(DrawCapturePath))
+	{
+		UE_LOG(LogImGui, Display, TEXT("ImGui draw data of %d frames written to %s"), DrawCapture->GetNumFrames(), *DrawCapturePath);
+	}
+	else
+	{
+		UE_LOG(LogImGui, Error, TEXT("Failed to write ImGui draw data to %s"), *DrawCapturePath);
+	}
+	DrawCapture.Reset();
+}
+
+bool UImGuiSubsystem::StartDrawReplay(const FString& FilePath, int32 Loops)
+{
+	StopDrawReplay();
+
+	TSharedRef<FImGuiDrawReplay> Replay = MakeShared<FImGuiDrawReplay>();
+	if (!Replay->Reader.Load(FilePath) || Replay->Reader.GetNumFrames() == 0)
+	{
+		UE_LOG(LogImGui, Error, TEXT("Failed to load ImGui draw data from %s"), *FilePath);
+		return false;
+	}
+
+	for (const FString& TextureName : Replay->Reader.GetTextureNames())
+	{
+		// @NOTE: Textures that can't be found fall back to the font atlas, the geometry is what replays are for
+		ImTextureID TextureId = TextureName.IsEmpty() ? nullptr : (ImTextureID)FontTextureBrush.Get();
+		UTexture* Texture = TextureName != CapturedFontTextureName && FPackageName::IsValidObjectPath(TextureName)
+			? LoadObject<UTexture>(nullptr, *TextureName)
+			: nullptr;
+		if (Texture)
+		{
+			TUniquePtr<FSlateBrush>& Brush = Replay->Brushes.Add_GetRef(MakeUnique<FSlateBrush>());
+			Brush->SetResourceObject(Texture);
+			Replay->LoadedTextures.Emplace(Texture);
+			TextureId = (ImTextureID)Brush.Get();
+		}
+		Replay->Textures.Add(TextureId);
+	}
+
+	Replay->LoopsLeft = Loops;
+	DrawReplay = Replay;
+	return true;
+}
+
+void UImGuiSubsystem::StopDrawReplay()
+{
+	if (!DrawReplay)
+	{
+		return;
+	}
+
+	for (const TSharedRef<SWindow>& Window : DrawReplay->Windows)
+	{
+		Window->RequestDestroyWindow();
+	}
+	DrawReplay.Reset();
+}
+
+void UImGuiSubsystem::TickDrawReplay()
+{
+	if (!DrawReplay->Reader.ReadFrame(DrawReplay->Frame, DrawReplay->Textures, DrawReplay->Viewports))
+	{
+		UE_LOG(LogImGui, Error, TEXT("ImGui replay stopped, frame %d of the capture is corrupted"), DrawReplay->Frame);
+		StopDrawReplay();
+		return;
+	}
+	for (FImGuiCapturedViewport& Viewport : DrawReplay->Viewports)
+	{
+		TSharedPtr<SImGuiCanvas>& Canvas = DrawReplay->Canvases.FindOrAdd(Viewport.ViewportId);
+		if (!Canvas)
+		{
+			// Replayed canvases aren't connected to any context, keep them from forwarding input to the current one
+			const ImVec2 DisplaySize = Viewport.DrawData.DisplaySize;
+			TSharedRef<SWindow> Window = SNew(SWindow).ClientSize({DisplaySize.x, DisplaySize.y}).
+			                                           Title(FText::Format(INVTEXT("ImGui Replay {0}"), Viewport.ViewportId)).
+			                                           Content()[SAssignNew(Canvas, SImGuiCanvas).Identifier("Replay").Visibility(EVisibility::HitTestInvisible)];
+			FSlateApplication::Get().AddWindow(Window);
+			DrawReplay->Windows.Add(Window);
+		}
+		Canvas->UpdateDrawData(&Viewport.DrawData);
+	}
+
+	if (++DrawReplay->Frame < DrawReplay->Reader.GetNumFrames())
+	{
+		return;
+	}
+
+	DrawReplay->Frame = 0;
+	if (DrawReplay->LoopsLeft > 0 && --DrawReplay->LoopsLeft == 0)
+	{
+		StopDrawReplay();
+	}
+}
+
+void UImGuiSubsystem::TickImGui(float DeltaTime)
+{
+	FImGuiPerfScope PerfScope(EImGuiPerfTimer::TickImGui);
+
+	// @NOTE: Modal loops and slow task progress tick Slate from within a Slate tick, a frame can still be in flight
+	if (Thread)
+	{
+		Thread->WaitForFrame();
+	}
+
+	SyncGameViewportContexts();
+
+	for (const TUniquePtr<FImGuiViewportContext>& ViewportContext : Contexts)
+	{
+		const double TickStartTime = FPlatformTime::Seconds();
+		{
+			FImGuiContextScope ContextScope(*ViewportContext);
+			TickContext(*ViewportContext, DeltaTime);
+		}
+		ViewportContext->LastTickTime = FPlatformTime::Seconds() - TickStartTime;
+	}
+
+	// Until a world ticks, ImGui calls go to the default context
+	ImGui::SetCurrentContext(Contexts[0]->Context);
+	ImPlot::SetCurrentContext(Contexts[0]->PlotContext);
+
+	if (GImGuiThreadEnable && !Thread)
+	{
+		Thread = MakeShared<FImGuiThread>(FontAtlas);
+	}
+	else if (!GImGuiThreadEnable && Thread)
+	{
+		Thread.Reset();
+	}
+
+	if (DrawReplay)
+	{
+		TickDrawReplay();
+	}
+
+	// Last, the frame is built while Slate ticks widgets and paints
+	if (Thread)
+	{
+		TArray<TSharedRef<FImGuiPanel, ESPMode::ThreadSafe>> PanelArray;
+		Panels.GenerateValueArray(PanelArray);
+		Thread->Tick(PanelArray, DeltaTime);
+	}
+}
+
+void UImGuiSubsystem::PostTickImGui(float DeltaTime)
+{
+	// Game thread code after the Slate tick may use ImGui, the ImGui thread has to give the current context back first
+	if (Thread)
+	{
+		Thread->WaitForFrame();
+	}
+}
+
+void UImGuiSubsystem::TickContext(FImGuiViewportContext& ViewportContext, float DeltaTime)
+{
+	IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_ContextTick, "ImGui Context Tick");
+
+	const ImGuiViewport* MainViewport = ImGui::GetMainViewport();
+	if (ViewportContext.bInImGuiFrame)
+	{
+		// Without the ImGui thread, registered panels are drawn by the default context
+		if (!Thread && &ViewportContext == Contexts[0].Get())
+		{
+			IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_Panels, "ImGui Registered Panels");
+			for (const TPair<FName, TSharedRef<FImGuiPanel, ESPMode::ThreadSafe>>& Panel : Panels)
+			{
+				const int32 FirstBeginOrder = ImGui::GetCurrentContext()->WindowsActiveCount;
+				const double PanelStartTime = FPlatformTime::Seconds();
+				if (Panel.Value->Snapshot)
+				{
+					Panel.Value->Snapshot();
+				}
+				if (Panel.Value->Draw)
+				{
+					Panel.Value->Draw();
+				}
+				if (GImGuiProfilerEnable)
+				{
+					AttributeBuildTime(ViewportContext, FirstBeginOrder, FPlatformTime::Seconds() - PanelStartTime);
+				}
+			}
+		}
+
+		if (GImGuiProfilerEnable && &ViewportContext == Contexts[0].Get())
+		{
+			DrawProfiler();
+		}
+
+		// Commands recorded by other threads for this context during the frame
+		int32 NumDeferredCommands;
+		{
+			IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_DeferredReplay, "ImGui Deferred Draw Replay");
+			NumDeferredCommands = FImGuiDeferredDraw::ReplaySubmitted([this, &ViewportContext](const UWorld* World)
+			{
+				return &GetContextForWorld(World) == &ViewportContext;
+			});
+		}
+		if (NumDeferredCommands > 0)
+		{
+			ViewportContext.LazyFramesToRender = FMath::Max(ViewportContext.LazyFramesToRender, 1);
+			INC_DWORD_STAT_BY(STAT_ImGui_DeferredCommandsReplayed, NumDeferredCommands);
+		}
+
+		if (ShouldRenderFrame(ViewportContext))
+		{
+			const double RenderStartTime = FPlatformTime::Seconds();
+
+			{
+				// UE_LOG(LogTemp, Warning, TEXT("=== ImGui Render ==="));
+				IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_Render, "ImGui Render");
+				ImGui::Render();
+			}
+			if (GImGuiProfilerEnable)
+			{
+				CollectWindowCosts(ViewportContext);
+			}
+			if (DrawCapture && &ViewportContext == Contexts[0].Get())
+			{
+				CaptureDrawData();
+			}
+
+			ImGui_ImplUnreal_RenderWindow(ImGui::GetMainViewport(), nullptr);
+			{
+				IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_UpdatePlatformWindows, "ImGui Update Platform Windows");
+				ImGui::UpdatePlatformWindows();
+				ImGui_ImplUnreal_FlushWindowUpdates();
+			}
+			ImGui::RenderPlatformWindowsDefault();
+			for (const ImGuiViewport* Viewport : ImGui::GetPlatformIO().Viewports)
+			{
+				// @NOTE: RenderPlatformWindowsDefault doesn't call RenderWindow for minimized viewports
+				ImGui_ImplUnreal_ViewportData* vd = (ImGui_ImplUnreal_ViewportData*)Viewport->PlatformUserData;
+				if (vd && (Viewport->Flags & ImGuiViewportFlags_IsMinimized))
+				{
+					vd->bDrawDataSkipped = true;
+				}
+				if (vd && vd->bDrawDataSkipped)
+				{
+					INC_DWORD_STAT(STAT_ImGui_ViewportsSkipped);
+				}
+			}
+			ImGui_ImplUnreal_PrepareCanvases(CanvasConversionJobs);
+			INC_DWORD_STAT_BY(STAT_ImGui_Viewports, ImGui::GetPlatformIO().Viewports.Size);
+
+			ViewportContext.LastRenderTime = FPlatformTime::Seconds();
+			ViewportContext.AverageRenderTime = FMath::Lerp(ViewportContext.AverageRenderTime, ViewportContext.LastRenderTime - RenderStartTime, 0.1);
+			ViewportContext.LastRenderedDisplaySize = {ImGui::GetIO().DisplaySize.x, ImGui::GetIO().DisplaySize.y};
+			ViewportContext.LastRenderedViewportCount = ImGui::GetCurrentContext()->Viewports.Size;
+			INC_DWORD_STAT(STAT_ImGui_FramesRendered);
+		}
+		else
+		{
+			// @NOTE: Nothing visible changed, canvases keep painting the draw data of the last rendered frame.
+			// Platform windows still have to be updated every frame
+			ImGui::EndFrame();
+			if (GImGuiProfilerEnable)
+			{
+				CollectWindowCosts(ViewportContext);
+			}
+			{
+				IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_UpdatePlatformWindows, "ImGui Update Platform Windows");
+				ImGui::UpdatePlatformWindows();
+				ImGui_ImplUnreal_FlushWindowUpdates();
+			}
+			INC_DWORD_STAT(STAT_ImGui_FramesSkipped);
+			INC_FLOAT_STAT_BY(STAT_ImGui_GameThreadTimeSaved, ViewportContext.AverageRenderTime * 1000.0);
+		}
+		ViewportContext.bInImGuiFrame = false;
+	}
+
+	// The default context only draws in the primary game viewport when game viewports don't get their own context
+	UGameViewportClient* GameViewport = ViewportContext.GameViewport.Get();
+	if (&ViewportContext == Contexts[0].Get() && !GImGuiPerGameViewportContexts)
+	{
+		GameViewport = GEngine->GameViewport;
+	}
+
+	if (ImGui_ImplUnreal_ViewportData* vd = (ImGui_ImplUnreal_ViewportData*)MainViewport->PlatformUserData)
+	{
+		if (vd->Canvas && vd->GameViewport != GameViewport)
+		// Cleanup MainViewport data if the game viewport is suddenly invalid
+		{
+			ImGui_ImplUnreal_ReleaseCanvas(vd);
+		}
+
+		if (GameViewport && !vd->Canvas) // Create the canvas if the GameViewport is valid
+		{
+			TSharedPtr<SImGuiCanvas> ImGuiCanvas;
+			vd->CanvasHost = MakeCanvasHost(SAssignNew(ImGuiCanvas, SImGuiCanvas)
+			                                .Identifier("Main")
+			                                .ViewportID(MainViewport->ID));
+			GameViewport->AddViewportWidgetContent(vd->CanvasHost.ToSharedRef(), 1000);
+
+			// FSlateApplication::Get().
+			vd->Hwnd = FindWindow(ImGuiCanvas);
+			vd->bHwndOwned = false;
+			vd->Canvas = ImGuiCanvas;
+			vd->GameViewport = GameViewport;
+		}
+	}
+
+	if (!ViewportContext.bInImGuiFrame)
+	{
+		ImGuiIO& IO = ImGui::GetIO();
 		IO.DeltaTime = DeltaTime;
 
+		// Mouse positions held back by the canvases go before the events pushed below
+		for (ImGuiViewport* Viewport : ImGui::GetPlatformIO().Viewports)
+		{
+			if (ImGui_ImplUnreal_ViewportData* ViewportData = (ImGui_ImplUnreal_ViewportData*)Viewport->PlatformUserData; ViewportData && ViewportData->Canvas)
+			{
+				ViewportData->Canvas->FlushPendingInput();
+			}
+		}
+
 		if (ImGui_ImplUnreal_ViewportData* vd = (ImGui_ImplUnreal_ViewportData*)MainViewport->PlatformUserData; vd && vd
 			->Canvas)
 		{
 			FVector2D ViewportSize;
-			GEngine->GameViewport->GetViewportSize(ViewportSize);
+			GameViewport->GetViewportSize(ViewportSize);
 			IO.DisplaySize = ImVec2{
 				(float)ViewportSize.X,
 				(float)ViewportSize.Y,
@@ -1025,10 +3542,175 @@ void UImGuiSubsystem::TickImGui(float DeltaTime)
 		IO.AddKeyEvent(ImGuiMod_Shift, FSlateApplication::Get().GetModifierKeys().IsShiftDown());
 		IO.AddKeyEvent(ImGuiMod_Alt, FSlateApplication::Get().GetModifierKeys().IsAltDown());
 		IO.AddKeyEvent(ImGuiMod_Super, FSlateApplication::Get().GetModifierKeys().IsCommandDown());
+
+		INC_DWORD_STAT_BY(STAT_ImGui_InputEventsQueued, ImGui::GetCurrentContext()->InputEventsQueue.Size);
+
+		// Monitors only change when the display metrics do, windows may have to move or change DPI scale
+		if (ImGui_ImplUnreal_UpdateMonitors(ViewportContext.MonitorsRevision))
+		{
+			ViewportContext.LazyFramesToRender = FMath::Max(ViewportContext.LazyFramesToRender, 1 + LazyFrameSettleCount);
+		}
 		
-		ImGui::NewFrame();
-		bInImGuiFrame = true;
+		{
+			IMGUI_SCOPE_CYCLE_COUNTER(STAT_ImGui_NewFrame, "ImGui NewFrame");
+			ImGui::NewFrame();
+		}
+		ViewportContext.bInImGuiFrame = true;
 	}
 }
 
-UE_ENABLE_OPTIMIZATION
+static FAutoConsoleCommand CmdImGuiContexts(
+	TEXT("ImGui.Contexts"),
+	TEXT("Lists the ImGui contexts with their game viewport and the game thread cost of their last frame"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const UImGuiSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UImGuiSubsystem>() : nullptr;
+		if (!Subsystem)
+		{
+			return;
+		}
+
+		for (const TUniquePtr<FImGuiViewportContext>& ViewportContext : Subsystem->GetContexts())
+		{
+			UE_LOG(LogImGui, Display, TEXT("ImGui context %s: %.3f ms tick, %.3f ms average render, %d viewports, %s"),
+			       *GetContextLabel(*ViewportContext),
+			       ViewportContext->LastTickTime * 1000.0,
+			       ViewportContext->AverageRenderTime * 1000.0,
+			       ViewportContext->Context->Viewports.Size,
+			       ANSI_TO_TCHAR(ViewportContext->IniFileName.ToString()));
+		}
+	})
+);
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FImGuiContextsTest, "UnrealImGuiDocker.Contexts",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Checks the contexts (one per PIE client with ImGui.Context.PerGameViewport) share the font atlas and that switching
+// to one restores the previous context, then logs the frame cost of each of them. Run it with PIE clients running.
+bool FImGuiContextsTest::RunTest(const FString& Parameters)
+{
+	const UImGuiSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UImGuiSubsystem>() : nullptr;
+	if (!TestNotNull(TEXT("ImGui subsystem"), Subsystem))
+	{
+		return false;
+	}
+
+	const TArray<TUniquePtr<FImGuiViewportContext>>& Contexts = Subsystem->GetContexts();
+	const FImGuiViewportContext& DefaultContext = *Contexts[0];
+	TestTrue(TEXT("The default context is current outside of world ticks"), ImGui::GetCurrentContext() == DefaultContext.Context);
+
+	for (int32 ContextIdx = 0; ContextIdx < Contexts.Num(); ++ContextIdx)
+	{
+		const FImGuiViewportContext& ViewportContext = *Contexts[ContextIdx];
+		const FString ContextLabel = GetContextLabel(ViewportContext);
+		TestTrue(FString::Printf(TEXT("%s shares the font atlas"), *ContextLabel), ViewportContext.Context->IO.Fonts == DefaultContext.Context->IO.Fonts);
+		for (int32 OtherIdx = 0; OtherIdx < ContextIdx; ++OtherIdx)
+		{
+			TestTrue(FString::Printf(TEXT("%s has contexts of its own"), *ContextLabel),
+			         ViewportContext.Context != Contexts[OtherIdx]->Context && ViewportContext.PlotContext != Contexts[OtherIdx]->PlotContext);
+		}
+
+		{
+			FImGuiContextScope ContextScope(ViewportContext);
+			TestTrue(FString::Printf(TEXT("%s is current in its scope"), *ContextLabel),
+			         ImGui::GetCurrentContext() == ViewportContext.Context && ImPlot::GetCurrentContext() == ViewportContext.PlotContext);
+		}
+		TestTrue(FString::Printf(TEXT("%s scope restores the previous context"), *ContextLabel), ImGui::GetCurrentContext() == DefaultContext.Context);
+
+		AddInfo(FString::Printf(TEXT("%s: %.3f ms tick, %.3f ms average render, %d viewports"),
+		                        *ContextLabel,
+		                        ViewportContext.LastTickTime * 1000.0,
+		                        ViewportContext.AverageRenderTime * 1000.0,
+		                        ViewportContext.Context->Viewports.Size));
+	}
+	return true;
+}
+
+#endif
+
+static FAutoConsoleCommand CmdImGuiProfilerDumpCsv(
+	TEXT("ImGui.Profiler.DumpCsv"),
+	TEXT("Writes the per window costs collected with ImGui.Profiler.Enable to a CSV file. Optional argument: file path, defaults to Saved/Profiling/ImGui"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const UImGuiSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UImGuiSubsystem>() : nullptr;
+		if (!Subsystem)
+		{
+			return;
+		}
+
+		TStringBuilder<4096> Csv;
+		Csv.Append(TEXT("Context,Window,Vertices,Indices,DrawCmds,BuildTimeMs\n"));
+		for (const TUniquePtr<FImGuiViewportContext>& ViewportContext : Subsystem->GetContexts())
+		{
+			const FString ContextLabel = GetContextLabel(*ViewportContext);
+			for (const TPair<uint32, FImGuiWindowCost>& Cost : ViewportContext->WindowCosts)
+			{
+				Csv.Appendf(TEXT("%s,\"%s\",%d,%d,%d,%.3f\n"), *ContextLabel, *Cost.Value.Name.Replace(TEXT("\""), TEXT("\"\"")),
+				            Cost.Value.Vertices, Cost.Value.Indices, Cost.Value.DrawCmds, Cost.Value.BuildTime * 1000.0);
+			}
+		}
+
+		const FString FilePath = Args.Num() > 0
+			? Args[0]
+			: FPaths::ProfilingDir() / TEXT("ImGui") / FString::Printf(TEXT("ImGuiProfiler-%s.csv"), *FDateTime::Now().ToString());
+		if (FFileHelper::SaveStringToFile(Csv.ToView(), *FilePath))
+		{
+			UE_LOG(LogImGui, Display, TEXT("ImGui window costs written to %s"), *IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*FilePath));
+		}
+		else
+		{
+			UE_LOG(LogImGui, Error, TEXT("Failed to write ImGui window costs to %s"), *FilePath);
+		}
+	})
+);
+
+static FAutoConsoleCommand CmdImGuiCapture(
+	TEXT("ImGui.Capture"),
+	TEXT("Writes the draw data of every viewport of the default ImGui context to an .imdraw file for the next rendered frames, see ImGui.Replay. ")
+	TEXT("Arguments: Frames=<count, default 60> File=<path, defaults to Saved/Profiling/ImGui>"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		UImGuiSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UImGuiSubsystem>() : nullptr;
+		if (!Subsystem)
+		{
+			return;
+		}
+
+		const FString Params = FString::Join(Args, TEXT(" "));
+		int32 Frames = 60;
+		FParse::Value(*Params, TEXT("Frames="), Frames);
+		FString FilePath = FPaths::ProfilingDir() / TEXT("ImGui") / FString::Printf(TEXT("ImGuiCapture-%s.imdraw"), *FDateTime::Now().ToString());
+		FParse::Value(*Params, TEXT("File="), FilePath);
+		Subsystem->StartDrawCapture(Frames, FilePath);
+	})
+);
+
+static FAutoConsoleCommand CmdImGuiReplay(
+	TEXT("ImGui.Replay"),
+	TEXT("Feeds the frames of an .imdraw file written by ImGui.Capture to canvases in windows of their own, one per captured viewport. ")
+	TEXT("Arguments: File=<path> Loops=<count, default 0: until ImGui.Replay Stop>"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		UImGuiSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UImGuiSubsystem>() : nullptr;
+		if (!Subsystem)
+		{
+			return;
+		}
+
+		if (Args.Contains(TEXT("Stop")))
+		{
+			Subsystem->StopDrawReplay();
+			return;
+		}
+
+		const FString Params = FString::Join(Args, TEXT(" "));
+		FString FilePath;
+		int32 Loops = 0;
+		FParse::Value(*Params, TEXT("File="), FilePath);
+		FParse::Value(*Params, TEXT("Loops="), Loops);
+		Subsystem->StartDrawReplay(FilePath, Loops);
+	})
+);
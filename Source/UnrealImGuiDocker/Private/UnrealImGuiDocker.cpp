@@ -2,6 +2,8 @@
 
 #include "UnrealImGuiDocker.h"
 
+DEFINE_LOG_CATEGORY(LogImGui);
+
 void FUnrealImGuiDockerModule::StartupModule() {}
 void FUnrealImGuiDockerModule::ShutdownModule() {}
 	
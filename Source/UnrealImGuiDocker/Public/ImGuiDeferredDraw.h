@@ -0,0 +1,52 @@
+﻿// Copyright Donatien Rabiller. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+// Records ImGui text, shapes and plot series from any thread, to be replayed into the next ImGui frame of the world's
+// context on the game thread. A recorder belongs to the thread using it, Submit hands its commands over without locking.
+//
+//	FImGuiDeferredDraw Draw(GetWorld());
+//	Draw.Text("AI", FString::Printf(TEXT("%d agents"), NumAgents));
+//	Draw.Line(From, To, FColor::Red);
+//	// Submitted when going out of scope
+class UNREALIMGUIDOCKER_API FImGuiDeferredDraw
+{
+public:
+	explicit FImGuiDeferredDraw(const UWorld* InWorld = nullptr);
+	~FImGuiDeferredDraw();
+
+	FImGuiDeferredDraw(const FImGuiDeferredDraw&) = delete;
+	FImGuiDeferredDraw& operator=(const FImGuiDeferredDraw&) = delete;
+
+	// Text line in the ImGui window named Window
+	void Text(FName Window, FStringView InText, FColor Color = FColor::White);
+
+	// Shapes drawn behind every ImGui window, in ImGui display coordinates
+	void Line(const FVector2f& From, const FVector2f& To, FColor Color, float Thickness = 1.0f);
+	void Rect(const FVector2f& Min, const FVector2f& Max, FColor Color, float Thickness = 1.0f, bool bFilled = false);
+	void Circle(const FVector2f& Center, float Radius, FColor Color, float Thickness = 1.0f, bool bFilled = false);
+
+	// Line series in the plot named Plot of the ImGui window named Window, series of every recorder share the plot
+	void PlotLine(FName Window, FName Plot, FName Series, TConstArrayView<float> Values);
+
+	// Hands the recorded commands to the game thread, the recorder can be reused afterwards
+	void Submit();
+
+	// Game thread only, with an ImGui frame open. Replays the submitted commands whose world passes the filter into the
+	// current context, returns the number of replayed commands. Commands of destroyed worlds, or left unreplayed for
+	// too many frames, are dropped.
+	static int32 ReplaySubmitted(TFunctionRef<bool(const UWorld*)> WorldFilter);
+
+	// Game thread only. Frees every submitted command that hasn't been replayed
+	static void DiscardSubmitted();
+
+	struct FCommandList;
+
+private:
+	const UWorld* World;
+	FCommandList* Commands = nullptr;
+};
@@ -5,6 +5,78 @@
 #include "Subsystems/EngineSubsystem.h"
 #include "ImGuiSubsystem.generated.h"
 
+struct ImFontAtlas;
+struct ImGuiContext;
+struct ImPlotContext;
+class FImGuiDrawCaptureWriter;
+class FImGuiThread;
+class SImGuiCanvas;
+struct FImGuiDrawReplay;
+class UGameViewportClient;
+
+// Cost of a top level ImGui window and its child windows, collected while ImGui.Profiler.Enable is set
+struct FImGuiWindowCost
+{
+	static constexpr int32 HistorySize = 120;
+
+	FString Name;
+	int32 Vertices = 0;
+	int32 Indices = 0;
+	int32 DrawCmds = 0;
+	double BuildTime = 0.0; // Seconds spent in the registered panel that began the window, game code isn't timed per window
+	double PendingBuildTime = 0.0; // Build time of the frame being built
+	uint64 LastFrame = 0; // GFrameCounter of the last frame the window was drawn
+
+	// Ring buffers of the last HistorySize ticks, starting at HistoryOffset
+	TArray<float> VertexHistory;
+	TArray<float> BuildTimeHistory; // In milliseconds
+	int32 HistoryOffset = 0;
+};
+
+// ImGui and ImPlot contexts drawn in one game viewport (or only in platform windows for the default context) along
+// with their frame state
+struct FImGuiViewportContext
+{
+	ImGuiContext* Context = nullptr;
+	ImPlotContext* PlotContext = nullptr;
+	TWeakObjectPtr<UGameViewportClient> GameViewport; // Unset for the default context
+	TAnsiStringBuilder<512> IniFileName;
+	bool bInImGuiFrame = false;
+	double LastTickTime = 0.0; // Game thread time of the last tick of this context, in seconds
+
+	// Lazy and rate limited frames state, see ImGui.Frame.Lazy and ImGui.Frame.MaxUpdateRate
+	int32 LazyFramesToRender = 0;
+	double LastRenderTime = 0.0;
+	double AverageRenderTime = 0.0; // Running average of the game thread time spent rendering a frame, in seconds
+	FVector2f LastRenderedDisplaySize = FVector2f::ZeroVector;
+	int32 LastRenderedViewportCount = 0;
+
+	uint32 MonitorsRevision = 0; // Revision of the monitor cache the context monitors were built from
+
+	TMap<uint32, FImGuiWindowCost> WindowCosts; // Keyed by ImGuiID of the top level window
+};
+
+// Panel drawn by the subsystem rather than from game code. Snapshot runs on the game thread and copies the game state
+// Draw needs, Draw only issues ImGui calls from that copy and runs on the ImGui thread when ImGui.Thread.Enable is set
+struct FImGuiPanel
+{
+	TFunction<void()> Snapshot;
+	TFunction<void()> Draw;
+};
+
+// Makes an ImGui context and its ImPlot context current for the lifetime of the scope
+class UNREALIMGUIDOCKER_API FImGuiContextScope
+{
+public:
+	explicit FImGuiContextScope(const FImGuiViewportContext& ViewportContext);
+	explicit FImGuiContextScope(const UWorld* World); // Context of the game viewport displaying World
+	~FImGuiContextScope();
+
+private:
+	ImGuiContext* PreviousContext;
+	ImPlotContext* PreviousPlotContext;
+};
+
 UCLASS()
 class UNREALIMGUIDOCKER_API UImGuiSubsystem : public UEngineSubsystem
 {
@@ -16,15 +88,61 @@ public:
 
 	UFUNCTION(BlueprintCallable)
 	static void WindowTest();
+
+	// Forces the current ImGui frame to be rendered when lazy frames are enabled, for changes that don't come from input
+	UFUNCTION(BlueprintCallable)
+	static void RequestRedraw();
+
+	// Context of the game viewport World is displayed in, the default context when it has none
+	const FImGuiViewportContext& GetContextForWorld(const UWorld* World) const;
+	const TArray<TUniquePtr<FImGuiViewportContext>>& GetContexts() const { return Contexts; }
+
+	// @NOTE: Draw can still run once after the panel is unregistered when the ImGui thread is building a frame
+	void RegisterPanel(FName Name, FImGuiPanel Panel);
+	void UnregisterPanel(FName Name);
+
+	// Writes the draw data of the next Frames rendered frames of the default context to an .imdraw file
+	void StartDrawCapture(int32 Frames, const FString& FilePath);
+	// Feeds the frames of an .imdraw file to canvases in windows of their own, Loops times over (0: until stopped)
+	bool StartDrawReplay(const FString& FilePath, int32 Loops);
+	void StopDrawReplay();
 	
 protected:
 	void WorldInitializedActors(const FActorsInitializedParams& ActorsInitializedParams);
+	void WorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void WorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
 	void TickImGui(float DeltaTime);
+	void PostTickImGui(float DeltaTime);
+	void TickContext(FImGuiViewportContext& ViewportContext, float DeltaTime);
+	bool ShouldRenderFrame(FImGuiViewportContext& ViewportContext) const;
+	void DrawProfiler();
+	void CaptureDrawData();
+	void TickDrawReplay();
+
+	FImGuiViewportContext& CreateContext(UGameViewportClient* GameViewport, const FString& IniName);
+	void DestroyContext(FImGuiViewportContext& ViewportContext);
+	void SyncGameViewportContexts();
+	void BeginMissingFrames();
+	FImGuiViewportContext* FindContextForWorld(const UWorld* World) const;
 
 	UPROPERTY()
 	TObjectPtr<UTexture2D> FontTexture;
 	TUniquePtr<FSlateBrush> FontTextureBrush;
+	ImFontAtlas* FontAtlas = nullptr; // Shared by every context
 
-	bool bInImGuiFrame = false;
-	TAnsiStringBuilder<512> IniFileName;
+	TArray<TUniquePtr<FImGuiViewportContext>> Contexts; // The first one is the default context
+	TOptional<FImGuiContextScope> WorldTickContextScope; // Context of the world being ticked, see WorldTickStart
+
+	TMap<FName, TSharedRef<FImGuiPanel, ESPMode::ThreadSafe>> Panels;
+	TSharedPtr<FImGuiThread> Thread;
+	TArray<TPair<SImGuiCanvas*, int32>> CanvasConversionJobs; // Draw lists converted by ImGui.Canvas.ParallelConversion
+
+	TSharedPtr<FImGuiDrawCaptureWriter> DrawCapture;
+	int32 DrawCaptureFramesLeft = 0;
+	FString DrawCapturePath;
+	TSharedPtr<FImGuiDrawReplay> DrawReplay;
+
+	// ImGui Profiler window selection
+	const ImGuiContext* ProfilerContext = nullptr; // Only compared against the contexts, unset for the default one
+	uint32 ProfilerSelectedWindow = 0;
 };
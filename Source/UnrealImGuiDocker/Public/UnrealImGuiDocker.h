@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
+UNREALIMGUIDOCKER_API DECLARE_LOG_CATEGORY_EXTERN(LogImGui, Log, All);
+
 class FUnrealImGuiDockerModule : public IModuleInterface
 {
 public:
@@ -39,7 +39,11 @@ public class UnrealImGuiDocker : ModuleRules
 				"ApplicationCore",
 				"UnrealEd",
 				"InputCore", 
+				"Json",
 				"ModelingComponents",
+				"RenderCore",
+				"RHI",
+				"UnrealImGuiDockerShaders",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
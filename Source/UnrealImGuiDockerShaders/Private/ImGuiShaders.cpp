@@ -0,0 +1,26 @@
+﻿// Copyright Donatien Rabiller. All rights reserved.
+
+#include "ImGuiShaders.h"
+
+#include "PipelineStateCache.h"
+
+IMPLEMENT_GLOBAL_SHADER(FImGuiVS, "/Plugin/UnrealImGuiDocker/Private/ImGui.usf", "MainVS", SF_Vertex);
+IMPLEMENT_GLOBAL_SHADER(FImGuiPS, "/Plugin/UnrealImGuiDocker/Private/ImGui.usf", "MainPS", SF_Pixel);
+
+TGlobalResource<FImGuiVertexDeclaration> GImGuiVertexDeclaration;
+
+void FImGuiVertexDeclaration::InitRHI(FRHICommandListBase& RHICmdList)
+{
+	constexpr uint16 Stride = sizeof(FImGuiShaderVertex);
+
+	FVertexDeclarationElementList Elements;
+	Elements.Add(FVertexElement(0, STRUCT_OFFSET(FImGuiShaderVertex, Position), VET_Float2, 0, Stride));
+	Elements.Add(FVertexElement(0, STRUCT_OFFSET(FImGuiShaderVertex, UV), VET_Float2, 1, Stride));
+	Elements.Add(FVertexElement(0, STRUCT_OFFSET(FImGuiShaderVertex, Color), VET_UByte4N, 2, Stride));
+	VertexDeclarationRHI = PipelineStateCache::GetOrCreateVertexDeclaration(Elements);
+}
+
+void FImGuiVertexDeclaration::ReleaseRHI()
+{
+	VertexDeclarationRHI.SafeRelease();
+}
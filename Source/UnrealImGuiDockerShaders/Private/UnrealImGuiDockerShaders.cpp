@@ -0,0 +1,23 @@
+﻿// Copyright Donatien Rabiller. All rights reserved.
+
+#include "Interfaces/IPluginManager.h"
+#include "Modules/ModuleManager.h"
+#include "ShaderCore.h"
+
+// Loaded at PostConfigInit so the global shaders are registered before the shader map is compiled
+class FUnrealImGuiDockerShadersModule : public IModuleInterface
+{
+public:
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+};
+
+void FUnrealImGuiDockerShadersModule::StartupModule()
+{
+	const FString ShaderDirectory = FPaths::Combine(IPluginManager::Get().FindPlugin(TEXT("UnrealImGuiDocker"))->GetBaseDir(), TEXT("Shaders"));
+	AddShaderSourceDirectoryMapping(TEXT("/Plugin/UnrealImGuiDocker"), ShaderDirectory);
+}
+
+void FUnrealImGuiDockerShadersModule::ShutdownModule() {}
+
+IMPLEMENT_MODULE(FUnrealImGuiDockerShadersModule, UnrealImGuiDockerShaders)
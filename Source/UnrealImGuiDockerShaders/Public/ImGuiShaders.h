@@ -0,0 +1,50 @@
+﻿// Copyright Donatien Rabiller. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalShader.h"
+#include "RenderResource.h"
+#include "ShaderParameterStruct.h"
+
+// Mirrors ImDrawVert, the vertex shader consumes ImGui vertices as is
+struct FImGuiShaderVertex
+{
+	FVector2f Position;
+	FVector2f UV;
+	uint32 Color; // RGBA8
+};
+
+class UNREALIMGUIDOCKERSHADERS_API FImGuiVS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FImGuiVS);
+	SHADER_USE_PARAMETER_STRUCT(FImGuiVS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER(FVector4f, ScaleAndOffset) // Window pixel space to clip space
+	END_SHADER_PARAMETER_STRUCT()
+};
+
+class UNREALIMGUIDOCKERSHADERS_API FImGuiPS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FImGuiPS);
+	SHADER_USE_PARAMETER_STRUCT(FImGuiPS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_TEXTURE(Texture2D, Texture)
+		SHADER_PARAMETER_SAMPLER(SamplerState, Sampler)
+	END_SHADER_PARAMETER_STRUCT()
+};
+
+class FImGuiVertexDeclaration : public FRenderResource
+{
+public:
+	FVertexDeclarationRHIRef VertexDeclarationRHI;
+
+	virtual void InitRHI(FRHICommandListBase& RHICmdList) override;
+	virtual void ReleaseRHI() override;
+};
+
+extern UNREALIMGUIDOCKERSHADERS_API TGlobalResource<FImGuiVertexDeclaration> GImGuiVertexDeclaration;
@@ -0,0 +1,27 @@
+﻿// Copyright Donatien Rabiller. All rights reserved.
+
+using UnrealBuildTool;
+
+public class UnrealImGuiDockerShaders : ModuleRules
+{
+	public UnrealImGuiDockerShaders(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"RenderCore",
+				"RHI",
+			}
+			);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Projects",
+			}
+			);
+	}
+}